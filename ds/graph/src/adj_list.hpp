@@ -1,20 +1,53 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
+#include <stdexcept>
 #include <unordered_map>
 #include <queue>
 
+#include "adjacency.hpp"
 #include "graph.hpp"
 
-template <Vertex V, Weight W>
+// vertices are interned into 32-bit dense ids and every row stores only targets and weights in the
+// chosen layout, the source is implied by the row. ids of removed vertices are reused.
+// with the in-edge index every edge is also kept in the row of its target, so predecessors can be
+// iterated directly and remove_vertex only touches the rows of the removed vertex's neighbours
+template <Vertex V, Weight W, AdjacencyLayout Layout = default_layout<W>>
 class AdjListGraph : public Graph<V, W> {
-    std::unordered_map<V, std::vector<Edge<V, W>>> adj_list;
+    using Row = AdjacencyRow<W, Layout>;
+
+    std::unordered_map<V, std::uint32_t> ids;
+    std::vector<V> labels;
+    std::vector<bool> live;
+    std::vector<std::uint32_t> free_slots;
+    std::vector<Row> rows;
+    std::vector<Row> in_rows; // sources of the edges into every vertex
+    bool in_index = false;
+
+    std::optional<std::uint32_t> find(const V& vtx) const {
+        const auto it = ids.find(vtx);
+        if (it == ids.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    void append_row(std::uint32_t from, std::vector<Edge<V, W>>& out) const {
+        rows[from].for_each([&](std::uint32_t to, const W& weight) {
+            out.push_back({labels[from], labels[to], weight});
+        });
+    }
+
 public:
+    using id_type = std::uint32_t;
+
     AdjListGraph() = default;
     ~AdjListGraph() = default;
 
-    AdjListGraph(const std::vector<Edge<V, W>>& edges) {
+    AdjListGraph(const std::vector<Edge<V, W>>& edges, bool in_edge_index = false) {
+        set_in_edge_index(in_edge_index);
         for (const auto& edge : edges) {
             add_vertex(edge.from);
             add_vertex(edge.to);
@@ -22,114 +55,332 @@ public:
         }
     }
 
+    bool has_in_edge_index() const {
+        return in_index;
+    }
+
+    void set_in_edge_index(bool enable) {
+        in_index = enable;
+        in_rows.clear();
+        if (!enable) {
+            return;
+        }
+        in_rows.resize(labels.size());
+        for (std::uint32_t from = 0; from < labels.size(); ++from) {
+            rows[from].for_each([&](std::uint32_t to, const W& weight) {
+                in_rows[to].push_back(from, weight);
+            });
+        }
+    }
+
     bool add_vertex(const V& vtx) override {
         if (has_vertex(vtx)) {
             return false;
         }
-        adj_list[vtx] = {};
+
+        std::uint32_t id;
+        if (!free_slots.empty()) {
+            id = free_slots.back();
+            free_slots.pop_back();
+            labels[id] = vtx;
+            live[id] = true;
+        } else {
+            if (labels.size() == std::numeric_limits<std::uint32_t>::max()) {
+                throw std::runtime_error("AdjListGraph is limited to 2^32 - 1 vertices");
+            }
+            id = static_cast<std::uint32_t>(labels.size());
+            labels.push_back(vtx);
+            live.push_back(true);
+            rows.emplace_back();
+            if (in_index) {
+                in_rows.emplace_back();
+            }
+        }
+        ids.emplace(vtx, id);
         return true;
     }
 
+    // drops the incident edges too, in O(neighbourhood) with the in-edge index and O(E) without
     bool remove_vertex(const V& vtx) override {
-        if (!has_vertex(vtx)) {
+        const auto it = ids.find(vtx);
+        if (it == ids.end()) {
             return false;
         }
-        adj_list.erase(vtx);
+        const auto id = it->second;
+        auto is_id = [id](std::uint32_t other, const W&) {
+            return other == id;
+        };
+
+        if (in_index) {
+            rows[id].for_each([&](std::uint32_t to, const W&) {
+                if (to != id) {
+                    in_rows[to].erase_if(is_id);
+                }
+            });
+            in_rows[id].for_each([&](std::uint32_t from, const W&) {
+                if (from != id) {
+                    rows[from].erase_if(is_id);
+                }
+            });
+            in_rows[id] = {};
+        } else {
+            for (std::uint32_t from = 0; from < labels.size(); ++from) {
+                if (live[from]) {
+                    rows[from].erase_if(is_id);
+                }
+            }
+        }
+        rows[id] = {};
+        live[id] = false;
+        free_slots.push_back(id);
+        ids.erase(it);
         return true;
     }
 
     bool has_vertex(const V& vtx) const override {
-        return adj_list.contains(vtx);
+        return ids.contains(vtx);
     }
 
     size_t vertex_count() const override {
-        return adj_list.size();
+        return ids.size();
     }
 
     std::vector<V> get_vertices() const override {
-        std::vector<V> vertices(adj_list.size());
-        std::transform(adj_list.begin(), adj_list.end(), vertices.begin(), [](const auto& pair) {
-            return pair.first;
-        });
+        std::vector<V> vertices;
+        vertices.reserve(ids.size());
+        for (std::uint32_t id = 0; id < labels.size(); ++id) {
+            if (live[id]) {
+                vertices.push_back(labels[id]);
+            }
+        }
         return vertices;
     }
 
     bool add_edge(const Edge<V, W>& edge) override {
-        if (!has_vertex(edge.from) || !has_vertex(edge.to)) {
+        const auto from = find(edge.from);
+        const auto to = find(edge.to);
+        if (!from || !to) {
             return false;
         }
-        adj_list[edge.from].push_back(edge);
+        rows[*from].push_back(*to, edge.weight);
+        if (in_index) {
+            in_rows[*to].push_back(*from, edge.weight);
+        }
         return true;
     }
 
     bool remove_edge(const V& from, const V& to) override {
-        if (!has_edge(from, to)) {
+        const auto from_id = find(from);
+        const auto to_id = find(to);
+        if (!from_id || !to_id || !rows[*from_id].find(*to_id)) {
             return false;
         }
-
-        adj_list[from].erase(
-            std::remove_if(
-                adj_list[from].begin(),
-                adj_list[from].end(),
-                [to](const Edge<V, W>& edge) {
-                    return edge.to == to;
-                }
-            ),
-            adj_list[from].end()
-        );
-
+        rows[*from_id].erase_if([&](std::uint32_t target, const W&) {
+            return target == *to_id;
+        });
+        if (in_index) {
+            in_rows[*to_id].erase_if([&](std::uint32_t source, const W&) {
+                return source == *from_id;
+            });
+        }
         return true;
     }
+
     bool has_edge(const V& from, const V& to) const override {
-        const auto it = adj_list.find(from);
-        if (it == adj_list.end()) {
-            return false;
-        }
-        return std::any_of(it->second.begin(), it->second.end(), [to](const Edge<V, W>& edge) {
-            return edge.to == to;
-        });
+        const auto from_id = find(from);
+        const auto to_id = find(to);
+        return from_id && to_id && rows[*from_id].find(*to_id);
     }
 
     std::optional<Edge<V, W>> get_edge(const V& from, const V& to) const override {
-        const auto it = adj_list.find(from);
-        if (it == adj_list.end()) {
+        const auto weight = get_weight(from, to);
+        if (!weight) {
             return std::nullopt;
         }
-        const auto edge = std::find_if(it->second.begin(), it->second.end(), [to](const Edge<V, W>& edge) {
-            return edge.to == to;
-        });
-        if (edge == it->second.end()) {
-            return std::nullopt;
-        }
-        return *edge;
+        return Edge<V, W>{from, to, *weight};
     }
 
     std::optional<W> get_weight(const V& from, const V& to) const override {
-        const auto it = adj_list.find(from);
-        if (it == adj_list.end()) {
+        const auto from_id = find(from);
+        const auto to_id = find(to);
+        if (!from_id || !to_id) {
             return std::nullopt;
         }
-        for (const auto& edge : it->second) {
-            if (edge.to == to) {
-                return edge.weight;
-            }
+        const auto i = rows[*from_id].find(*to_id);
+        if (!i) {
+            return std::nullopt;
         }
-        return std::nullopt;
+        return rows[*from_id].weight(*i);
     }
 
     std::vector<Edge<V, W>> get_edges() const override {
         std::vector<Edge<V, W>> result;
-        for (const auto& [from, edge_list] : adj_list) {
-            result.insert(result.end(), edge_list.begin(), edge_list.end());
+        for (std::uint32_t id = 0; id < labels.size(); ++id) {
+            if (live[id]) {
+                append_row(id, result);
+            }
         }
         return result;
     }
 
     std::optional<std::vector<Edge<V, W>>> get_edges(const V& vtx) const override {
-        const auto it = adj_list.find(vtx);
-        if (it == adj_list.end()) {
+        const auto id = find(vtx);
+        if (!id) {
             return std::nullopt; // no neighbors
         }
-        return std::make_optional(it->second);
+        std::vector<Edge<V, W>> result;
+        result.reserve(rows[*id].size());
+        append_row(*id, result);
+        return std::make_optional(result);
+    }
+
+    std::optional<std::vector<Edge<V, W>>> get_in_edges(const V& vtx) const override {
+        if (!in_index) {
+            return Graph<V, W>::get_in_edges(vtx);
+        }
+        const auto id = find(vtx);
+        if (!id) {
+            return std::nullopt;
+        }
+        std::vector<Edge<V, W>> result;
+        result.reserve(in_rows[*id].size());
+        in_rows[*id].for_each([&](std::uint32_t from, const W& weight) {
+            result.push_back({labels[from], vtx, weight});
+        });
+        return std::make_optional(result);
+    }
+
+    // updates are bucketed by source and every touched row is rewritten once: a single pass drops
+    // removed edges and overwrites reweighted ones, the insertions are appended after one reserve.
+    // the last update of a (from, to) pair wins and parallel edges of an updated pair collapse into one
+    void apply_batch(const std::vector<EdgeUpdate<V, W>>& updates) override {
+        std::vector<const EdgeUpdate<V, W>*> sorted(updates.size());
+        std::transform(updates.begin(), updates.end(), sorted.begin(), [](const auto& update) {
+            return &update;
+        });
+        std::stable_sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+            return std::tie(a->from, a->to) < std::tie(b->from, b->to);
+        });
+
+        std::vector<const EdgeUpdate<V, W>*> last;
+        std::vector<std::pair<std::uint32_t, const EdgeUpdate<V, W>*>> targets;
+        std::vector<bool> placed;
+        for (std::size_t begin = 0; begin < sorted.size();) {
+            const auto& from = sorted[begin]->from;
+            auto end = begin;
+            last.clear();
+            bool inserts = false;
+            for (; end < sorted.size() && sorted[end]->from == from; ++end) {
+                if (end + 1 == sorted.size() || sorted[end + 1]->from != from || sorted[end + 1]->to != sorted[end]->to) {
+                    last.push_back(sorted[end]);
+                    inserts |= sorted[end]->weight.has_value();
+                }
+            }
+            begin = end;
+            if (!inserts && !has_vertex(from)) {
+                continue;
+            }
+            if (inserts) {
+                add_vertex(from);
+                for (const auto* update : last) {
+                    if (update->weight) {
+                        add_vertex(update->to);
+                    }
+                }
+            }
+
+            // removals towards unknown vertices have nothing to drop
+            const auto from_id = ids.at(from);
+            targets.clear();
+            for (const auto* update : last) {
+                if (const auto to_id = find(update->to)) {
+                    targets.push_back({*to_id, update});
+                }
+            }
+            std::sort(targets.begin(), targets.end(), [](const auto& a, const auto& b) {
+                return a.first < b.first;
+            });
+            auto position = [&](std::uint32_t to) -> std::ptrdiff_t {
+                const auto it = std::lower_bound(targets.begin(), targets.end(), to, [](const auto& target, std::uint32_t to) {
+                    return target.first < to;
+                });
+                return it != targets.end() && it->first == to ? it - targets.begin() : -1;
+            };
+
+            placed.assign(targets.size(), false);
+            auto& row = rows[from_id];
+            row.erase_if([&](std::uint32_t to, W& weight) {
+                const auto i = position(to);
+                if (i < 0) {
+                    return false;
+                }
+                if (!targets[i].second->weight || placed[i]) {
+                    return true;
+                }
+                weight = *targets[i].second->weight;
+                placed[i] = true;
+                return false;
+            });
+            std::size_t appended = 0;
+            for (std::size_t i = 0; i < targets.size(); ++i) {
+                appended += targets[i].second->weight && !placed[i];
+            }
+            row.reserve(appended);
+            for (std::size_t i = 0; i < targets.size(); ++i) {
+                if (targets[i].second->weight && !placed[i]) {
+                    row.push_back(targets[i].first, *targets[i].second->weight);
+                }
+            }
+
+            if (in_index) {
+                for (const auto& [to_id, update] : targets) {
+                    in_rows[to_id].erase_if([&](std::uint32_t source, const W&) {
+                        return source == from_id;
+                    });
+                    if (update->weight) {
+                        in_rows[to_id].push_back(from_id, *update->weight);
+                    }
+                }
+            }
+        }
+    }
+
+    // GraphView access, rows are visited in place
+    std::size_t id_bound() const {
+        return labels.size();
+    }
+
+    std::optional<std::uint32_t> index_of(const V& vtx) const {
+        return find(vtx);
+    }
+
+    const V& label(std::uint32_t id) const {
+        return labels[id];
+    }
+
+    template <typename F>
+    void for_each_vertex(F&& fn) const {
+        for (std::uint32_t id = 0; id < labels.size(); ++id) {
+            if (live[id]) {
+                fn(id);
+            }
+        }
+    }
+
+    template <typename F>
+    void for_each_neighbor(std::uint32_t id, F&& fn) const {
+        rows[id].for_each(fn);
+    }
+
+    // heap bytes of the out- and in-edge rows
+    std::size_t adjacency_bytes() const {
+        std::size_t bytes = 0;
+        for (const auto& row : rows) {
+            bytes += row.bytes();
+        }
+        for (const auto& row : in_rows) {
+            bytes += row.bytes();
+        }
+        return bytes;
     }
-};
\ No newline at end of file
+};
@@ -1,17 +1,78 @@
 #pragma once
 
+#include "aligned.hpp"
 #include "graph.hpp"
 
+#include <bit>
+#include <cstdint>
 #include <unordered_map>
 
+// dense V x V matrix over interned vertex ids, weights live in one contiguous row-major buffer
+// with cache line aligned rows and a presence bitmap marks which cells hold an edge. the optional
+// in-edge index is the transposed presence bitmap, so columns can be walked word by word too
 template <Vertex V, Weight W>
 class AdjMatrixGraph : public Graph<V, W> {
-    std::unordered_map<V, std::unordered_map<V, W>> adj_matrix;
+    std::unordered_map<V, std::size_t> ids;
+    std::vector<V> labels;
+    std::vector<bool> live;
+    std::vector<std::size_t> free_slots;
+
+    std::size_t capacity = 0;
+    std::size_t stride = 0; // weights per row, capacity padded to a cache line
+    std::size_t words = 0;  // bitmap words per row
+    std::vector<W, AlignedAllocator<W>> weights;
+    std::vector<std::uint64_t, AlignedAllocator<std::uint64_t>> present;
+    std::vector<std::uint64_t, AlignedAllocator<std::uint64_t>> present_in; // present_in[to][from]
+    bool in_index = false;
+
+    void grow(std::size_t new_capacity) {
+        const auto new_stride = round_up(new_capacity, cache_line_elements<W>());
+        const auto new_words = round_up(new_capacity, 64) / 64;
+        std::vector<W, AlignedAllocator<W>> new_weights(new_capacity * new_stride);
+        std::vector<std::uint64_t, AlignedAllocator<std::uint64_t>> new_present(new_capacity * new_words, 0);
+        std::vector<std::uint64_t, AlignedAllocator<std::uint64_t>> new_present_in(in_index ? new_capacity * new_words : 0, 0);
+
+        for (std::size_t row = 0; row < capacity; ++row) {
+            std::copy_n(weights.begin() + row * stride, capacity, new_weights.begin() + row * new_stride);
+            std::copy_n(present.begin() + row * words, words, new_present.begin() + row * new_words);
+            if (in_index) {
+                std::copy_n(present_in.begin() + row * words, words, new_present_in.begin() + row * new_words);
+            }
+        }
+
+        capacity = new_capacity;
+        stride = new_stride;
+        words = new_words;
+        weights = std::move(new_weights);
+        present = std::move(new_present);
+        present_in = std::move(new_present_in);
+    }
+
+    bool test(std::size_t from, std::size_t to) const {
+        return (present[from * words + to / 64] >> (to % 64)) & 1u;
+    }
+
+    static void clear_bit(std::uint64_t* bits, std::size_t i) {
+        bits[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+    }
+
+    template <typename F>
+    void for_each_bit(const std::uint64_t* bits, F&& fn) const {
+        for (std::size_t word = 0; word < words; ++word) {
+            for (auto mask = bits[word]; mask != 0; mask &= mask - 1) {
+                fn(word * 64 + std::countr_zero(mask));
+            }
+        }
+    }
+
 public:
+    using id_type = std::size_t;
+
     AdjMatrixGraph() = default;
     ~AdjMatrixGraph() = default;
 
-    AdjMatrixGraph(const std::vector<Edge<V, W>>& edges) {
+    AdjMatrixGraph(const std::vector<Edge<V, W>>& edges, bool in_edge_index = false) {
+        set_in_edge_index(in_edge_index);
         for (const auto& edge : edges) {
             add_vertex(edge.from);
             add_vertex(edge.to);
@@ -23,98 +84,251 @@ public:
         if (has_vertex(vtx)) {
             return false;
         }
-        adj_matrix.insert({vtx, {}});
+
+        std::size_t id;
+        if (!free_slots.empty()) {
+            id = free_slots.back();
+            free_slots.pop_back();
+            labels[id] = vtx;
+            live[id] = true;
+        } else {
+            id = labels.size();
+            if (id == capacity) {
+                grow(std::max<std::size_t>(capacity * 2, 8));
+            }
+            labels.push_back(vtx);
+            live.push_back(true);
+        }
+        ids.emplace(vtx, id);
         return true;
     }
 
+    bool has_in_edge_index() const {
+        return in_index;
+    }
+
+    void set_in_edge_index(bool enable) {
+        in_index = enable;
+        present_in.assign(enable ? capacity * words : 0, 0);
+        if (!enable) {
+            return;
+        }
+        for (std::size_t from = 0; from < labels.size(); ++from) {
+            for_each_bit(row_bits(from), [&](std::size_t to) {
+                present_in[to * words + from / 64] |= std::uint64_t{1} << (from % 64);
+            });
+        }
+    }
+
+    // clears the vertex row and column, so no edge into a removed vertex is left behind. with the
+    // in-edge index only the cells of actual neighbours are touched instead of every row
     bool remove_vertex(const V& vtx) override {
-        if (!has_vertex(vtx)) {
+        const auto it = ids.find(vtx);
+        if (it == ids.end()) {
             return false;
         }
-        adj_matrix.erase(vtx);
+        const auto id = it->second;
+        if (in_index) {
+            for_each_bit(row_bits(id), [&](std::size_t to) {
+                clear_bit(present_in.data() + to * words, id);
+            });
+            for_each_bit(in_row_bits(id), [&](std::size_t from) {
+                clear_bit(present.data() + from * words, id);
+            });
+            std::fill_n(present_in.begin() + id * words, words, 0);
+        } else {
+            for (std::size_t row = 0; row < labels.size(); ++row) {
+                clear_bit(present.data() + row * words, id);
+            }
+        }
+        std::fill_n(present.begin() + id * words, words, 0);
+        live[id] = false;
+        free_slots.push_back(id);
+        ids.erase(it);
         return true;
     }
 
     bool has_vertex(const V& vtx) const override {
-        return adj_matrix.contains(vtx);
+        return ids.contains(vtx);
     }
 
     size_t vertex_count() const override {
-        return adj_matrix.size();
+        return ids.size();
     }
 
     std::vector<V> get_vertices() const override {
-        std::vector<V> vertices(adj_matrix.size());
-        std::transform(adj_matrix.begin(), adj_matrix.end(), vertices.begin(), [](const auto& pair) {
-            return pair.first;
-        });
+        std::vector<V> vertices;
+        vertices.reserve(ids.size());
+        for (std::size_t id = 0; id < labels.size(); ++id) {
+            if (live[id]) {
+                vertices.push_back(labels[id]);
+            }
+        }
         return vertices;
     }
 
     bool add_edge(const Edge<V, W>& edge) override {
-        if (!has_vertex(edge.from) || !has_vertex(edge.to)) {
+        const auto from = index_of(edge.from);
+        const auto to = index_of(edge.to);
+        if (!from || !to) {
             return false;
         }
-        adj_matrix[edge.from][edge.to] = edge.weight;
+        weights[*from * stride + *to] = edge.weight;
+        present[*from * words + *to / 64] |= std::uint64_t{1} << (*to % 64);
+        if (in_index) {
+            present_in[*to * words + *from / 64] |= std::uint64_t{1} << (*from % 64);
+        }
         return true;
     }
-    
+
     bool remove_edge(const V& from, const V& to) override {
         if (!has_edge(from, to)) {
             return false;
         }
-        adj_matrix[from].erase(to);
+        const auto from_id = ids.at(from);
+        const auto to_id = ids.at(to);
+        clear_bit(present.data() + from_id * words, to_id);
+        if (in_index) {
+            clear_bit(present_in.data() + to_id * words, from_id);
+        }
         return true;
     }
-    
+
     bool has_edge(const V& from, const V& to) const override {
-        const auto row_it = adj_matrix.find(from);
-        return row_it != adj_matrix.end() && row_it->second.contains(to);
+        const auto from_id = index_of(from);
+        const auto to_id = index_of(to);
+        return from_id && to_id && test(*from_id, *to_id);
     }
 
     std::optional<Edge<V, W>> get_edge(const V& from, const V& to) const override {
-        const auto row_it = adj_matrix.find(from);
-        if (row_it == adj_matrix.end()) {
+        const auto weight = get_weight(from, to);
+        if (!weight) {
             return std::nullopt;
         }
-        const auto weight_it = row_it->second.find(to);
-        if (weight_it == row_it->second.end()) {
-            return std::nullopt;
-        }
-        return Edge<V, W>{from, to, weight_it->second};
+        return Edge<V, W>{from, to, *weight};
     }
 
     std::optional<W> get_weight(const V& from, const V& to) const override {
-        const auto row_it = adj_matrix.find(from);
-        if (row_it == adj_matrix.end()) {
-            return std::nullopt;
-        }
-        const auto weight_it = row_it->second.find(to);
-        if (weight_it == row_it->second.end()) {
+        const auto from_id = index_of(from);
+        const auto to_id = index_of(to);
+        if (!from_id || !to_id || !test(*from_id, *to_id)) {
             return std::nullopt;
         }
-        return weight_it->second;
+        return weights[*from_id * stride + *to_id];
     }
 
     std::vector<Edge<V, W>> get_edges() const override {
         std::vector<Edge<V, W>> edges;
-        for (const auto& [from, row] : adj_matrix) {
-            for (const auto& [to, weight] : row) {
-                edges.push_back({from, to, weight});
+        for (std::size_t id = 0; id < labels.size(); ++id) {
+            if (live[id]) {
+                append_row(id, edges);
             }
         }
         return edges;
     }
 
     std::optional<std::vector<Edge<V, W>>> get_edges(const V& vtx) const override {
-        const auto row_it = adj_matrix.find(vtx);
-        if (row_it == adj_matrix.end()) {
+        const auto id = index_of(vtx);
+        if (!id) {
             return std::nullopt;
         }
         std::vector<Edge<V, W>> neighbors;
-        for (const auto& [to, weight] : row_it->second) {
-            neighbors.push_back({vtx, to, weight});
-        }
+        append_row(*id, neighbors);
         return neighbors;
     }
+
+    // walks the in-edge bitmap when it is kept and every live row's cell of the column otherwise
+    std::optional<std::vector<Edge<V, W>>> get_in_edges(const V& vtx) const override {
+        const auto id = index_of(vtx);
+        if (!id) {
+            return std::nullopt;
+        }
+        std::vector<Edge<V, W>> predecessors;
+        auto add = [&](std::size_t from) {
+            predecessors.push_back({labels[from], vtx, weights[from * stride + *id]});
+        };
+        if (in_index) {
+            for_each_bit(in_row_bits(*id), add);
+        } else {
+            for (std::size_t from = 0; from < labels.size(); ++from) {
+                if (test(from, *id)) {
+                    add(from);
+                }
+            }
+        }
+        return predecessors;
+    }
+
+    // dense id access, ids are stable until the vertex is removed and may be reused afterwards
+    std::optional<std::size_t> index_of(const V& vtx) const {
+        const auto it = ids.find(vtx);
+        if (it == ids.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    const V& label(std::size_t id) const {
+        return labels[id];
+    }
+
+    // upper bound on ids in use, slots of removed vertices are included but have no edges
+    std::size_t slot_count() const {
+        return labels.size();
+    }
+
+    bool is_live(std::size_t id) const {
+        return live[id];
+    }
+
+    // GraphView access, removed slots are skipped and a row is read straight off its bitmap
+    std::size_t id_bound() const {
+        return labels.size();
+    }
+
+    template <typename F>
+    void for_each_vertex(F&& fn) const {
+        for (std::size_t id = 0; id < labels.size(); ++id) {
+            if (live[id]) {
+                fn(id);
+            }
+        }
+    }
+
+    template <typename F>
+    void for_each_neighbor(std::size_t from, F&& fn) const {
+        const auto* weight_row = row(from);
+        for_each_bit(row_bits(from), [&](std::size_t to) {
+            fn(to, weight_row[to]);
+        });
+    }
+
+    bool has_edge_at(std::size_t from, std::size_t to) const {
+        return test(from, to);
+    }
+
+    const W& weight_at(std::size_t from, std::size_t to) const {
+        return weights[from * stride + to];
+    }
+
+    const W* row(std::size_t from) const {
+        return weights.data() + from * stride;
+    }
+
+    const std::uint64_t* row_bits(std::size_t from) const {
+        return present.data() + from * words;
+    }
+
+    // sources of the edges into `to`, only available with the in-edge index
+    const std::uint64_t* in_row_bits(std::size_t to) const {
+        return present_in.data() + to * words;
+    }
+
+private:
+    void append_row(std::size_t from, std::vector<Edge<V, W>>& out) const {
+        const auto* weight_row = row(from);
+        for_each_bit(row_bits(from), [&](std::size_t to) {
+            out.push_back({labels[from], labels[to], weight_row[to]});
+        });
+    }
 };
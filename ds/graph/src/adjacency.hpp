@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "graph.hpp"
+
+// storage of one adjacency row over 32-bit dense vertex ids, the row owner is implied
+enum class AdjacencyLayout {
+    Packed,     // one array of {target, weight} records
+    Split,      // targets and weights in parallel arrays, no padding after the target
+    Unweighted, // targets only, every edge reads back with weight 1
+};
+
+// records stay packed while they fit 8 bytes without padding, wider weights go to their own array
+template <Weight W>
+inline constexpr AdjacencyLayout default_layout =
+    sizeof(W) <= sizeof(std::uint32_t) && alignof(W) <= alignof(std::uint32_t)
+        ? AdjacencyLayout::Packed
+        : AdjacencyLayout::Split;
+
+// every row offers the same interface: size, target(i), weight(i), find(target), push_back,
+// reserve, erase_if(pred(target, weight&)) whose predicate may rewrite kept weights,
+// for_each(fn(target, weight)) and bytes() for the heap footprint
+template <Weight W, AdjacencyLayout Layout>
+class AdjacencyRow;
+
+template <Weight W>
+class AdjacencyRow<W, AdjacencyLayout::Packed> {
+    struct Entry {
+        std::uint32_t target;
+        W weight;
+    };
+    std::vector<Entry> entries;
+
+public:
+    std::size_t size() const {
+        return entries.size();
+    }
+
+    std::uint32_t target(std::size_t i) const {
+        return entries[i].target;
+    }
+
+    const W& weight(std::size_t i) const {
+        return entries[i].weight;
+    }
+
+    std::optional<std::size_t> find(std::uint32_t target) const {
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].target == target) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void push_back(std::uint32_t target, const W& weight) {
+        entries.push_back({target, weight});
+    }
+
+    void reserve(std::size_t extra) {
+        entries.reserve(entries.size() + extra);
+    }
+
+    template <typename P>
+    void erase_if(P&& pred) {
+        std::erase_if(entries, [&](Entry& entry) {
+            return pred(entry.target, entry.weight);
+        });
+    }
+
+    template <typename F>
+    void for_each(F&& fn) const {
+        for (const auto& entry : entries) {
+            fn(entry.target, entry.weight);
+        }
+    }
+
+    std::size_t bytes() const {
+        return entries.capacity() * sizeof(Entry);
+    }
+};
+
+template <Weight W>
+class AdjacencyRow<W, AdjacencyLayout::Split> {
+    std::vector<std::uint32_t> targets;
+    std::vector<W> weights;
+
+public:
+    std::size_t size() const {
+        return targets.size();
+    }
+
+    std::uint32_t target(std::size_t i) const {
+        return targets[i];
+    }
+
+    const W& weight(std::size_t i) const {
+        return weights[i];
+    }
+
+    std::optional<std::size_t> find(std::uint32_t target) const {
+        const auto it = std::find(targets.begin(), targets.end(), target);
+        if (it == targets.end()) {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>(it - targets.begin());
+    }
+
+    void push_back(std::uint32_t target, const W& weight) {
+        targets.push_back(target);
+        weights.push_back(weight);
+    }
+
+    void reserve(std::size_t extra) {
+        targets.reserve(targets.size() + extra);
+        weights.reserve(weights.size() + extra);
+    }
+
+    // compacts both arrays in one pass
+    template <typename P>
+    void erase_if(P&& pred) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < targets.size(); ++i) {
+            if (!pred(targets[i], weights[i])) {
+                targets[kept] = targets[i];
+                weights[kept] = std::move(weights[i]);
+                ++kept;
+            }
+        }
+        targets.resize(kept);
+        weights.resize(kept);
+    }
+
+    template <typename F>
+    void for_each(F&& fn) const {
+        for (std::size_t i = 0; i < targets.size(); ++i) {
+            fn(targets[i], weights[i]);
+        }
+    }
+
+    std::size_t bytes() const {
+        return targets.capacity() * sizeof(std::uint32_t) + weights.capacity() * sizeof(W);
+    }
+};
+
+template <Weight W>
+class AdjacencyRow<W, AdjacencyLayout::Unweighted> {
+    std::vector<std::uint32_t> targets;
+
+public:
+    std::size_t size() const {
+        return targets.size();
+    }
+
+    std::uint32_t target(std::size_t i) const {
+        return targets[i];
+    }
+
+    W weight(std::size_t) const {
+        return W(1);
+    }
+
+    std::optional<std::size_t> find(std::uint32_t target) const {
+        const auto it = std::find(targets.begin(), targets.end(), target);
+        if (it == targets.end()) {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>(it - targets.begin());
+    }
+
+    // the weight is dropped
+    void push_back(std::uint32_t target, const W&) {
+        targets.push_back(target);
+    }
+
+    void reserve(std::size_t extra) {
+        targets.reserve(targets.size() + extra);
+    }
+
+    template <typename P>
+    void erase_if(P&& pred) {
+        std::erase_if(targets, [&](std::uint32_t target) {
+            W weight(1);
+            return pred(target, weight);
+        });
+    }
+
+    template <typename F>
+    void for_each(F&& fn) const {
+        const W weight(1);
+        for (const auto target : targets) {
+            fn(target, weight);
+        }
+    }
+
+    std::size_t bytes() const {
+        return targets.capacity() * sizeof(std::uint32_t);
+    }
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// allocator for std::vector that starts every buffer on a cache line
+template <typename T, std::size_t Align = CACHE_LINE_SIZE>
+struct AlignedAllocator {
+    using value_type = T;
+
+    static constexpr std::align_val_t alignment{std::max(Align, alignof(T))};
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), alignment));
+    }
+
+    void deallocate(T* ptr, std::size_t) {
+        ::operator delete(ptr, alignment);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const {
+        return true;
+    }
+};
+
+// number of T that fit in one cache line, used to pad matrix rows
+template <typename T>
+constexpr std::size_t cache_line_elements() {
+    return std::max<std::size_t>(1, CACHE_LINE_SIZE / sizeof(T));
+}
+
+constexpr std::size_t round_up(std::size_t value, std::size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
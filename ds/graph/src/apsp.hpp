@@ -0,0 +1,328 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "adj_list.hpp"
+#include "adj_matrix.hpp"
+#include "aligned.hpp"
+#include "graph.hpp"
+#include "thread_pool.hpp"
+
+// weights with a numeric_limits specialization, needed to encode "no path" inside the matrix
+template <typename T>
+concept MatrixWeight = Weight<T> && std::numeric_limits<T>::is_specialized;
+
+namespace apsp_detail {
+    // integral infinity is half the range so inf + w cannot overflow, distances beyond
+    // inf / 2 in magnitude are treated as unreachable and have to stay out of real paths
+    template <MatrixWeight W>
+    constexpr W infinity() {
+        if constexpr (std::numeric_limits<W>::has_infinity) {
+            return std::numeric_limits<W>::infinity();
+        } else {
+            return std::numeric_limits<W>::max() / 2;
+        }
+    }
+
+    template <MatrixWeight W>
+    constexpr bool reachable(const W& value) {
+        if constexpr (std::numeric_limits<W>::has_infinity) {
+            return value != infinity<W>();
+        } else {
+            return value < infinity<W>() / 2;
+        }
+    }
+
+    // c[j] = min(c[j], dik + b[j]) over one block row, integral results are clamped at -inf
+    // so that negative cycles cannot drive the sums into overflow
+    template <MatrixWeight W>
+    inline void min_plus_row(W* c, const W* b, const W dik, const std::size_t len) {
+#if defined(__AVX2__)
+        if constexpr (std::is_same_v<W, std::int32_t>) {
+            const auto vdik = _mm256_set1_epi32(dik);
+            const auto vfloor = _mm256_set1_epi32(-infinity<W>());
+            for (std::size_t j = 0; j < len; j += 8) {
+                const auto vb = _mm256_load_si256(reinterpret_cast<const __m256i*>(b + j));
+                const auto vc = _mm256_load_si256(reinterpret_cast<const __m256i*>(c + j));
+                const auto sum = _mm256_max_epi32(_mm256_add_epi32(vdik, vb), vfloor);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(c + j), _mm256_min_epi32(vc, sum));
+            }
+            return;
+        } else if constexpr (std::is_same_v<W, float>) {
+            const auto vdik = _mm256_set1_ps(dik);
+            for (std::size_t j = 0; j < len; j += 8) {
+                const auto sum = _mm256_add_ps(vdik, _mm256_load_ps(b + j));
+                _mm256_store_ps(c + j, _mm256_min_ps(_mm256_load_ps(c + j), sum));
+            }
+            return;
+        } else if constexpr (std::is_same_v<W, double>) {
+            const auto vdik = _mm256_set1_pd(dik);
+            for (std::size_t j = 0; j < len; j += 4) {
+                const auto sum = _mm256_add_pd(vdik, _mm256_load_pd(b + j));
+                _mm256_store_pd(c + j, _mm256_min_pd(_mm256_load_pd(c + j), sum));
+            }
+            return;
+        }
+#endif
+        for (std::size_t j = 0; j < len; ++j) {
+            W sum = dik + b[j];
+            if constexpr (std::numeric_limits<W>::is_signed && !std::numeric_limits<W>::has_infinity) {
+                sum = std::max(sum, W(-infinity<W>()));
+            }
+            c[j] = std::min(c[j], sum);
+        }
+    }
+
+    // relaxes block (bi, bj) through every k of block bk, k runs outermost so the kernel
+    // stays correct when the output block is also one of the inputs
+    template <MatrixWeight W>
+    void update_block(W* values, std::size_t stride, std::size_t block, std::size_t bi, std::size_t bj, std::size_t bk) {
+        const auto i0 = bi * block;
+        const auto j0 = bj * block;
+        const auto k0 = bk * block;
+        for (auto k = k0; k < k0 + block; ++k) {
+            const W* b = values + k * stride + j0;
+            for (auto i = i0; i < i0 + block; ++i) {
+                const W dik = values[i * stride + k];
+                if (!reachable(dik)) {
+                    continue;
+                }
+                min_plus_row(values + i * stride + j0, b, dik, block);
+            }
+        }
+    }
+
+    // block edge length, a multiple of one cache line of weights
+    template <MatrixWeight W>
+    constexpr std::size_t block_size() {
+        return round_up(std::max<std::size_t>(64, cache_line_elements<W>()), cache_line_elements<W>());
+    }
+}
+
+// dense all-pairs result, vertices are numbered 0..size()-1 in `labels` order
+template <Vertex V, MatrixWeight W>
+class DistanceMatrix {
+    std::vector<V> labels;
+    std::unordered_map<V, std::size_t> ids;
+    std::size_t stride = 0;
+    std::vector<W, AlignedAllocator<W>> values;
+
+public:
+    DistanceMatrix(std::vector<V> vertices, std::size_t stride)
+        : labels(std::move(vertices)),
+          stride(stride),
+          values(stride * stride, apsp_detail::infinity<W>())
+    {
+        ids.reserve(labels.size());
+        for (std::size_t i = 0; i < labels.size(); ++i) {
+            ids.emplace(labels[i], i);
+        }
+        for (std::size_t i = 0; i < stride; ++i) {
+            values[i * stride + i] = W{0};
+        }
+    }
+
+    std::size_t size() const {
+        return labels.size();
+    }
+
+    const V& label(std::size_t id) const {
+        return labels[id];
+    }
+
+    std::optional<std::size_t> index_of(const V& vtx) const {
+        const auto it = ids.find(vtx);
+        if (it == ids.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    std::optional<W> at(std::size_t from, std::size_t to) const {
+        const auto& value = values[from * stride + to];
+        if (!apsp_detail::reachable(value)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    std::optional<W> distance(const V& from, const V& to) const {
+        const auto from_id = index_of(from);
+        const auto to_id = index_of(to);
+        if (!from_id || !to_id) {
+            return std::nullopt;
+        }
+        return at(*from_id, *to_id);
+    }
+
+    // distances are meaningless when this is true
+    bool has_negative_cycle() const {
+        for (std::size_t i = 0; i < labels.size(); ++i) {
+            if (values[i * stride + i] < W{0}) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // raw row-major storage, rows are `stride` long and may be padded past size()
+    std::size_t row_stride() const {
+        return stride;
+    }
+
+    W* data() {
+        return values.data();
+    }
+
+    const W* data() const {
+        return values.data();
+    }
+
+    void relax(std::size_t from, std::size_t to, const W& weight) {
+        auto& value = values[from * stride + to];
+        value = std::min(value, weight);
+    }
+};
+
+// blocked floyd-warshall: per diagonal block the pivot block is closed first, then its block
+// row and column, then every remaining block, the last two phases run in parallel
+template <Vertex V, MatrixWeight W>
+void floyd_warshall(DistanceMatrix<V, W>& matrix, ThreadPool& pool) {
+    constexpr auto block = apsp_detail::block_size<W>();
+    const auto stride = matrix.row_stride();
+    const auto blocks = stride / block;
+    W* values = matrix.data();
+
+    for (std::size_t bk = 0; bk < blocks; ++bk) {
+        apsp_detail::update_block(values, stride, block, bk, bk, bk);
+
+        pool.parallel_for(2 * (blocks - 1), [&](std::size_t task, std::size_t) {
+            auto other = task / 2;
+            other += other >= bk;
+            if (task % 2 == 0) {
+                apsp_detail::update_block(values, stride, block, bk, other, bk);
+            } else {
+                apsp_detail::update_block(values, stride, block, other, bk, bk);
+            }
+        });
+
+        const auto rest = blocks - 1;
+        pool.parallel_for(rest * rest, [&](std::size_t task, std::size_t) {
+            auto bi = task / rest;
+            auto bj = task % rest;
+            bi += bi >= bk;
+            bj += bj >= bk;
+            apsp_detail::update_block(values, stride, block, bi, bj, bk);
+        });
+    }
+}
+
+template <Vertex V, MatrixWeight W>
+DistanceMatrix<V, W> all_pairs_shortest_paths(const AdjMatrixGraph<V, W>& graph, ThreadPool& pool) {
+    // compact live slots into consecutive ids
+    std::vector<std::size_t> slots;
+    std::vector<V> vertices;
+    std::vector<std::size_t> compact(graph.slot_count());
+    for (std::size_t slot = 0; slot < graph.slot_count(); ++slot) {
+        if (graph.is_live(slot)) {
+            compact[slot] = slots.size();
+            slots.push_back(slot);
+            vertices.push_back(graph.label(slot));
+        }
+    }
+
+    const auto stride = round_up(std::max<std::size_t>(vertices.size(), 1), apsp_detail::block_size<W>());
+    DistanceMatrix<V, W> matrix(std::move(vertices), stride);
+    for (const auto from : slots) {
+        for (const auto to : slots) {
+            if (graph.has_edge_at(from, to)) {
+                matrix.relax(compact[from], compact[to], graph.weight_at(from, to));
+            }
+        }
+    }
+
+    floyd_warshall(matrix, pool);
+    return matrix;
+}
+
+template <Vertex V, MatrixWeight W>
+DistanceMatrix<V, W> all_pairs_shortest_paths(const AdjMatrixGraph<V, W>& graph, std::size_t threads = std::thread::hardware_concurrency()) {
+    ThreadPool pool(threads);
+    return all_pairs_shortest_paths(graph, pool);
+}
+
+// johnson's algorithm for sparse graphs with negative weights: potentials from one bellman-ford,
+// then a dijkstra per source on the reweighted graph, sources are spread over the pool and every
+// worker reuses its own SearchContext. on_row(source, row) receives the distances from `source`
+// to every vertex in get_vertices() order and is called concurrently from the workers.
+// returns false without calling on_row when the graph has a negative cycle
+template <Vertex V, Weight W, typename F>
+bool johnson(const Graph<V, W>& graph, ThreadPool& pool, F&& on_row) {
+    const auto potential = graph.potentials();
+    if (!potential) {
+        return false;
+    }
+
+    const auto vertices = graph.get_vertices();
+    std::unordered_map<V, std::size_t> ids;
+    ids.reserve(vertices.size());
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        ids.emplace(vertices[i], i);
+    }
+
+    auto edges = graph.get_edges();
+    for (auto& edge : edges) {
+        edge.weight = edge.weight + potential->at(edge.from) - potential->at(edge.to);
+    }
+    const AdjListGraph<V, W> reweighted(edges);
+
+    std::vector<SearchContext<V, W>> contexts(pool.size());
+    std::vector<std::vector<std::optional<W>>> rows(pool.size());
+    pool.parallel_for(vertices.size(), [&](std::size_t source, std::size_t slot) {
+        auto& context = contexts[slot];
+        auto& row = rows[slot];
+        row.assign(vertices.size(), std::nullopt);
+
+        const auto& from = vertices[source];
+        const auto from_potential = potential->at(from);
+        row[source] = W{0};
+        reweighted.dijkstra_visit(from, context, [&](std::size_t id) {
+            const auto& to = context.label(id);
+            row[ids.at(to)] = context.distance(id) - from_potential + potential->at(to);
+            return false;
+        });
+        on_row(from, std::as_const(row));
+    });
+    return true;
+}
+
+template <Vertex V, MatrixWeight W>
+std::optional<DistanceMatrix<V, W>> johnson(const Graph<V, W>& graph, ThreadPool& pool) {
+    const auto vertices = graph.get_vertices();
+    DistanceMatrix<V, W> matrix(vertices, round_up(std::max<std::size_t>(vertices.size(), 1), cache_line_elements<W>()));
+
+    // every worker writes a different matrix row
+    const auto ok = johnson(graph, pool, [&](const V& source, const std::vector<std::optional<W>>& row) {
+        const auto from = *matrix.index_of(source);
+        for (std::size_t to = 0; to < row.size(); ++to) {
+            if (row[to]) {
+                matrix.relax(from, to, *row[to]);
+            }
+        }
+    });
+    if (!ok) {
+        return std::nullopt;
+    }
+    return matrix;
+}
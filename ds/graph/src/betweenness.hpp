@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "csr.hpp"
+#include "thread_pool.hpp"
+
+struct BetweennessOptions {
+    bool weighted = true;              // dijkstra on the edge weights, false counts hops with bfs
+    std::size_t samples = 0;           // 0 runs every source, k > 0 samples k sources and scales by n / k
+    std::uint64_t seed = 280131;       // for the sampled sources
+};
+
+namespace betweenness_detail {
+    constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+    // state of one single source pass, sized once per graph. only vertices reached from the source
+    // are touched and reset afterwards, so a pass costs O(reached) rather than O(n)
+    template <Weight W>
+    struct Workspace {
+        std::vector<double> sigma;         // shortest path counts, 0 marks unreached
+        std::vector<double> delta;         // dependency of the source on every vertex
+        std::vector<W> distance;
+        std::vector<std::uint32_t> depth;
+        std::vector<std::uint32_t> order;  // reached vertices in non-decreasing distance
+        std::vector<std::pair<W, std::uint32_t>> heap;
+
+        explicit Workspace(std::size_t n)
+            : sigma(n, 0.0), delta(n, 0.0), distance(n), depth(n, NONE) {}
+    };
+}
+
+// brandes betweenness over the dense ids of a CsrGraph, edges are directed. every source runs one
+// shortest path pass that counts paths and then accumulates dependencies in reverse settle order,
+// successors are recognised by distance[w] == distance[v] + w(v, w) so no predecessor lists are kept.
+// sources are spread over the pool, each worker adds into its own score vector and the vectors are
+// summed at the end. workspaces and score vectors live as long as the engine
+template <Vertex V, Weight W>
+class Betweenness {
+    const CsrGraph<V, W>& graph;
+    ThreadPool* pool;
+    std::vector<betweenness_detail::Workspace<W>> workspaces;
+    std::vector<std::vector<double>> scores;
+
+    template <bool Weighted>
+    void single_source(std::uint32_t source, betweenness_detail::Workspace<W>& ws, std::vector<double>& score) const {
+        auto& order = ws.order;
+        order.clear();
+        ws.sigma[source] = 1.0;
+
+        if constexpr (Weighted) {
+            ws.distance[source] = W{0};
+            ws.heap.assign(1, {W{0}, source});
+            while (!ws.heap.empty()) {
+                std::pop_heap(ws.heap.begin(), ws.heap.end(), std::greater<>{});
+                const auto [distance, u] = ws.heap.back();
+                ws.heap.pop_back();
+                // skip stale heap entries
+                if (distance > ws.distance[u]) {
+                    continue;
+                }
+                order.push_back(u);
+                const auto targets = graph.neighbors(u);
+                const auto weights = graph.neighbor_weights(u);
+                for (std::size_t i = 0; i < targets.size(); ++i) {
+                    const auto v = targets[i];
+                    const auto new_distance = distance + weights[i];
+                    if (ws.sigma[v] == 0.0 || new_distance < ws.distance[v]) {
+                        ws.distance[v] = new_distance;
+                        ws.sigma[v] = ws.sigma[u];
+                        ws.heap.push_back({new_distance, v});
+                        std::push_heap(ws.heap.begin(), ws.heap.end(), std::greater<>{});
+                    } else if (new_distance == ws.distance[v]) {
+                        ws.sigma[v] += ws.sigma[u];
+                    }
+                }
+            }
+        } else {
+            ws.depth[source] = 0;
+            order.push_back(source);
+            for (std::size_t head = 0; head < order.size(); ++head) {
+                const auto u = order[head];
+                for (const auto v : graph.neighbors(u)) {
+                    if (ws.depth[v] == betweenness_detail::NONE) {
+                        ws.depth[v] = ws.depth[u] + 1;
+                        order.push_back(v);
+                    }
+                    if (ws.depth[v] == ws.depth[u] + 1) {
+                        ws.sigma[v] += ws.sigma[u];
+                    }
+                }
+            }
+        }
+
+        for (auto i = order.size(); i-- > 0;) {
+            const auto v = order[i];
+            const auto targets = graph.neighbors(v);
+            const auto weights = graph.neighbor_weights(v);
+            double dependency = 0.0;
+            for (std::size_t k = 0; k < targets.size(); ++k) {
+                const auto w = targets[k];
+                bool successor;
+                if constexpr (Weighted) {
+                    successor = ws.sigma[w] != 0.0 && ws.distance[w] == ws.distance[v] + weights[k];
+                } else {
+                    successor = ws.depth[w] == ws.depth[v] + 1;
+                }
+                if (successor) {
+                    dependency += ws.sigma[v] / ws.sigma[w] * (1.0 + ws.delta[w]);
+                }
+            }
+            ws.delta[v] = dependency;
+            if (v != source) {
+                score[v] += dependency;
+            }
+        }
+
+        for (const auto v : order) {
+            ws.sigma[v] = 0.0;
+            ws.delta[v] = 0.0;
+            ws.depth[v] = betweenness_detail::NONE;
+        }
+    }
+
+public:
+    explicit Betweenness(const CsrGraph<V, W>& graph, ThreadPool* pool = nullptr)
+        : graph(graph), pool(pool)
+    {
+        const auto slots = pool ? pool->size() : 1;
+        workspaces.reserve(slots);
+        for (std::size_t slot = 0; slot < slots; ++slot) {
+            workspaces.emplace_back(graph.size());
+        }
+        scores.assign(slots, std::vector<double>(graph.size()));
+    }
+
+    // unnormalized scores per dense id: the sum over sources s and targets t of the fraction of
+    // shortest s-t paths through the vertex. weighted runs need positive weights, zero weight ties
+    // would break the settle order the counting relies on
+    std::vector<double> run(const BetweennessOptions& options = {}) {
+        const auto n = graph.size();
+        if (options.weighted) {
+            for (const auto& weight : graph.edge_weights()) {
+                if (!(W{} < weight)) {
+                    throw std::invalid_argument("weighted betweenness requires positive weights");
+                }
+            }
+        }
+
+        std::vector<std::uint32_t> sources(n);
+        std::iota(sources.begin(), sources.end(), 0);
+        double scale = 1.0;
+        if (options.samples > 0 && options.samples < n) {
+            // partial fisher-yates, the first k entries are a uniform sample without repetition
+            std::mt19937_64 gen(options.seed);
+            for (std::size_t i = 0; i < options.samples; ++i) {
+                std::uniform_int_distribution<std::size_t> pick(i, n - 1);
+                std::swap(sources[i], sources[pick(gen)]);
+            }
+            sources.resize(options.samples);
+            scale = static_cast<double>(n) / options.samples;
+        }
+
+        for (auto& score : scores) {
+            std::fill(score.begin(), score.end(), 0.0);
+        }
+        parallel_chunks(pool, sources.size(), 1, [&](std::size_t i, std::size_t slot) {
+            if (options.weighted) {
+                single_source<true>(sources[i], workspaces[slot], scores[slot]);
+            } else {
+                single_source<false>(sources[i], workspaces[slot], scores[slot]);
+            }
+        });
+
+        std::vector<double> result(n, 0.0);
+        for (const auto& score : scores) {
+            for (std::uint32_t v = 0; v < n; ++v) {
+                result[v] += score[v];
+            }
+        }
+        for (auto& value : result) {
+            value *= scale;
+        }
+        return result;
+    }
+};
+
+template <Vertex V, Weight W>
+std::vector<double> betweenness_centrality(const CsrGraph<V, W>& graph, ThreadPool* pool = nullptr, const BetweennessOptions& options = {}) {
+    return Betweenness<V, W>(graph, pool).run(options);
+}
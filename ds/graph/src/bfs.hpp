@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "csr.hpp"
+#include "thread_pool.hpp"
+
+// direction-optimizing breadth first search (beamer et al.) over a CsrGraph, levels are expanded
+// top-down from a frontier queue while the frontier is small and bottom-up from a frontier bitmap
+// (every unvisited vertex looks for a parent among its in-neighbors) once it is large.
+// the engine keeps its buffers between runs, pass a pool to expand every level in parallel
+template <Vertex V, Weight W>
+class Bfs {
+public:
+    static constexpr std::uint32_t UNREACHED = std::numeric_limits<std::uint32_t>::max();
+
+    // switch to bottom-up when frontier edges exceed unexplored edges / ALPHA,
+    // back to top-down when the frontier shrinks below vertices / BETA
+    static constexpr std::size_t ALPHA = 14;
+    static constexpr std::size_t BETA = 24;
+
+private:
+    static constexpr std::size_t CHUNK = 1024;
+
+    const CsrGraph<V, W>& graph;
+    CsrGraph<V, W> in_edges;
+
+    std::vector<std::uint32_t> depth;
+    std::vector<std::uint32_t> parent;
+    std::vector<std::uint32_t> frontier;
+    std::vector<std::uint64_t> frontier_bits;
+    std::vector<std::uint64_t> next_bits;
+
+    // per worker scratch for parallel levels
+    struct Slot {
+        std::vector<std::uint32_t> next;
+        std::size_t found = 0;
+        std::size_t edges = 0;
+    };
+    std::vector<Slot> slots;
+
+public:
+    explicit Bfs(const CsrGraph<V, W>& graph)
+        : graph(graph),
+          in_edges(graph.transpose())
+    {}
+
+    // hop count from `source` to every vertex indexed by dense id, UNREACHED where there is no path
+    const std::vector<std::uint32_t>& run(const V& source, ThreadPool* pool = nullptr) {
+        const auto id = graph.index_of(source);
+        if (!id) {
+            depth.assign(graph.size(), UNREACHED);
+            return depth;
+        }
+        search(*id, UNREACHED, pool);
+        return depth;
+    }
+
+    // stops as soon as `to` is discovered
+    std::optional<std::uint32_t> hops(const V& from, const V& to, ThreadPool* pool = nullptr) {
+        const auto from_id = graph.index_of(from);
+        const auto to_id = graph.index_of(to);
+        if (!from_id || !to_id) {
+            return std::nullopt;
+        }
+        search(*from_id, *to_id, pool);
+        if (depth[*to_id] == UNREACHED) {
+            return std::nullopt;
+        }
+        return depth[*to_id];
+    }
+
+    bool reachable(const V& from, const V& to, ThreadPool* pool = nullptr) {
+        return hops(from, to, pool).has_value();
+    }
+
+    // bfs tree of the last run, the source is its own parent
+    const std::vector<std::uint32_t>& parents() const {
+        return parent;
+    }
+
+    const std::vector<std::uint32_t>& depths() const {
+        return depth;
+    }
+
+private:
+    void search(std::uint32_t source, std::uint32_t target, ThreadPool* pool) {
+        const auto n = graph.size();
+        const auto words = (static_cast<std::size_t>(n) + 63) / 64;
+        depth.assign(n, UNREACHED);
+        parent.assign(n, UNREACHED);
+        frontier_bits.assign(words, 0);
+        next_bits.assign(words, 0);
+        slots.resize(pool ? pool->size() : 1);
+
+        depth[source] = 0;
+        parent[source] = source;
+        frontier.assign(1, source);
+
+        std::size_t frontier_size = 1;
+        std::size_t frontier_edges = graph.degree(source);
+        std::size_t unexplored_edges = graph.edge_count() - frontier_edges;
+        bool bottom_up = false;
+
+        for (std::uint32_t level = 0; frontier_size > 0; ++level) {
+            if (target != UNREACHED && depth[target] != UNREACHED) {
+                return;
+            }
+
+            if (!bottom_up && frontier_edges > unexplored_edges / ALPHA) {
+                bottom_up = true;
+                std::fill(frontier_bits.begin(), frontier_bits.end(), 0);
+                for (const auto u : frontier) {
+                    frontier_bits[u / 64] |= std::uint64_t{1} << (u % 64);
+                }
+            } else if (bottom_up && frontier_size < n / BETA) {
+                bottom_up = false;
+                frontier.clear();
+                for (std::size_t word = 0; word < words; ++word) {
+                    for (auto mask = frontier_bits[word]; mask != 0; mask &= mask - 1) {
+                        frontier.push_back(static_cast<std::uint32_t>(word * 64 + std::countr_zero(mask)));
+                    }
+                }
+            }
+
+            for (auto& slot : slots) {
+                slot.next.clear();
+                slot.found = 0;
+                slot.edges = 0;
+            }
+
+            if (bottom_up) {
+                const auto chunks = (words + CHUNK / 64 - 1) / (CHUNK / 64);
+                parallel_chunks(pool, chunks, 1, [&](std::size_t chunk, std::size_t slot) {
+                    bottom_up_step(chunk * (CHUNK / 64), std::min(words, (chunk + 1) * (CHUNK / 64)), level, slots[slot]);
+                });
+                std::swap(frontier_bits, next_bits);
+            } else {
+                const auto chunks = (frontier.size() + CHUNK - 1) / CHUNK;
+                parallel_chunks(pool, chunks, 1, [&](std::size_t chunk, std::size_t slot) {
+                    const auto end = std::min(frontier.size(), (chunk + 1) * CHUNK);
+                    top_down_step(chunk * CHUNK, end, level, slots[slot], pool != nullptr);
+                });
+                frontier.clear();
+                for (const auto& slot : slots) {
+                    frontier.insert(frontier.end(), slot.next.begin(), slot.next.end());
+                }
+            }
+
+            frontier_size = 0;
+            frontier_edges = 0;
+            for (const auto& slot : slots) {
+                frontier_size += slot.found;
+                frontier_edges += slot.edges;
+            }
+            unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+        }
+    }
+
+    void top_down_step(std::size_t begin, std::size_t end, std::uint32_t level, Slot& slot, bool concurrent) {
+        for (auto i = begin; i < end; ++i) {
+            const auto u = frontier[i];
+            for (const auto v : graph.neighbors(u)) {
+                if (concurrent) {
+                    std::atomic_ref<std::uint32_t> claim(depth[v]);
+                    auto expected = UNREACHED;
+                    if (claim.load(std::memory_order_relaxed) != UNREACHED
+                        || !claim.compare_exchange_strong(expected, level + 1, std::memory_order_relaxed)) {
+                        continue;
+                    }
+                } else {
+                    if (depth[v] != UNREACHED) {
+                        continue;
+                    }
+                    depth[v] = level + 1;
+                }
+                parent[v] = u;
+                slot.next.push_back(v);
+                slot.found++;
+                slot.edges += graph.degree(v);
+            }
+        }
+    }
+
+    // every chunk owns whole bitmap words, so no two workers touch the same vertex
+    void bottom_up_step(std::size_t word_begin, std::size_t word_end, std::uint32_t level, Slot& slot) {
+        const auto n = graph.size();
+        for (auto word = word_begin; word < word_end; ++word) {
+            std::uint64_t found = 0;
+            const auto first = static_cast<std::uint32_t>(word * 64);
+            const auto last = std::min<std::uint32_t>(n, first + 64);
+            for (auto v = first; v < last; ++v) {
+                if (depth[v] != UNREACHED) {
+                    continue;
+                }
+                for (const auto u : in_edges.neighbors(v)) {
+                    if ((frontier_bits[u / 64] >> (u % 64)) & 1u) {
+                        depth[v] = level + 1;
+                        parent[v] = u;
+                        found |= std::uint64_t{1} << (v % 64);
+                        slot.found++;
+                        slot.edges += graph.degree(v);
+                        break;
+                    }
+                }
+            }
+            next_bits[word] = found;
+        }
+    }
+};
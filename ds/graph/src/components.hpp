@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include "csr.hpp"
+#include "thread_pool.hpp"
+
+// component id per vertex, ids are 0..count-1 in order of the smallest dense id they contain
+template <typename Map>
+struct Components {
+    Map component;
+    std::uint32_t count = 0;
+};
+
+namespace components_detail {
+    constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+    inline std::uint32_t load(std::vector<std::uint32_t>& parent, std::uint32_t i) {
+        return std::atomic_ref<std::uint32_t>(parent[i]).load(std::memory_order_relaxed);
+    }
+
+    // lock-free hooking: the larger root is pointed at the smaller one with a CAS and the
+    // walk restarts from the grandparents whenever another thread got there first
+    inline void link(std::vector<std::uint32_t>& parent, std::uint32_t u, std::uint32_t v) {
+        auto p1 = load(parent, u);
+        auto p2 = load(parent, v);
+        while (p1 != p2) {
+            const auto high = std::max(p1, p2);
+            const auto low = std::min(p1, p2);
+            auto p_high = load(parent, high);
+            if (p_high == low) {
+                return;
+            }
+            if (p_high == high
+                && std::atomic_ref<std::uint32_t>(parent[high]).compare_exchange_strong(p_high, low, std::memory_order_relaxed)) {
+                return;
+            }
+            p1 = load(parent, load(parent, high));
+            p2 = load(parent, low);
+        }
+    }
+
+    // renumbers arbitrary per-vertex representatives into 0..count-1
+    inline std::uint32_t relabel(std::vector<std::uint32_t>& component) {
+        std::vector<std::uint32_t> ids(component.size(), NONE);
+        std::uint32_t count = 0;
+        for (auto& c : component) {
+            if (ids[c] == NONE) {
+                ids[c] = count++;
+            }
+            c = ids[c];
+        }
+        return count;
+    }
+
+    template <Vertex V, Weight W, typename Dense>
+    Components<std::unordered_map<V, std::uint32_t>> to_labels(const CsrGraph<V, W>& csr, const Dense& dense) {
+        Components<std::unordered_map<V, std::uint32_t>> result;
+        result.count = dense.count;
+        result.component.reserve(csr.size());
+        for (std::uint32_t id = 0; id < csr.size(); ++id) {
+            result.component.emplace(csr.label(id), dense.component[id]);
+        }
+        return result;
+    }
+}
+
+// parallel union-find over every edge (shiloach-vishkin style hooking followed by pointer jumping),
+// edge direction is ignored
+template <Vertex V, Weight W>
+Components<std::vector<std::uint32_t>> weakly_connected_components(const CsrGraph<V, W>& graph, ThreadPool* pool = nullptr) {
+    using namespace components_detail;
+    constexpr std::size_t CHUNK = 256;
+
+    const auto n = graph.size();
+    std::vector<std::uint32_t> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+
+    parallel_chunks(pool, n, CHUNK, [&](std::size_t u, std::size_t) {
+        for (const auto v : graph.neighbors(static_cast<std::uint32_t>(u))) {
+            link(parent, static_cast<std::uint32_t>(u), v);
+        }
+    });
+
+    // roots only ever decrease, so a single pointer jumping pass per vertex reaches the root
+    parallel_chunks(pool, n, CHUNK, [&](std::size_t u, std::size_t) {
+        auto root = load(parent, static_cast<std::uint32_t>(u));
+        while (root != load(parent, root)) {
+            root = load(parent, root);
+        }
+        std::atomic_ref<std::uint32_t>(parent[u]).store(root, std::memory_order_relaxed);
+    });
+
+    Components<std::vector<std::uint32_t>> result;
+    result.component = std::move(parent);
+    result.count = relabel(result.component);
+    return result;
+}
+
+// iterative tarjan, no recursion so deep graphs cannot overflow the stack
+template <Vertex V, Weight W>
+Components<std::vector<std::uint32_t>> strongly_connected_components(const CsrGraph<V, W>& graph) {
+    using components_detail::NONE;
+
+    const auto n = graph.size();
+    std::vector<std::uint32_t> index(n, NONE);
+    std::vector<std::uint32_t> low(n, 0);
+    std::vector<std::uint32_t> component(n, NONE);
+    std::vector<std::uint32_t> stack;
+    std::vector<std::pair<std::uint32_t, std::size_t>> calls; // vertex, next neighbor position
+    std::uint32_t next_index = 0;
+    std::uint32_t count = 0;
+
+    for (std::uint32_t root = 0; root < n; ++root) {
+        if (index[root] != NONE) {
+            continue;
+        }
+        index[root] = low[root] = next_index++;
+        stack.push_back(root);
+        calls.push_back({root, 0});
+
+        while (!calls.empty()) {
+            auto& [u, pos] = calls.back();
+            const auto neighbors = graph.neighbors(u);
+            if (pos < neighbors.size()) {
+                const auto v = neighbors[pos++];
+                if (index[v] == NONE) {
+                    index[v] = low[v] = next_index++;
+                    stack.push_back(v);
+                    calls.push_back({v, 0});
+                } else if (component[v] == NONE) {
+                    low[u] = std::min(low[u], index[v]);
+                }
+                continue;
+            }
+
+            const auto done = u;
+            calls.pop_back();
+            if (!calls.empty()) {
+                const auto caller = calls.back().first;
+                low[caller] = std::min(low[caller], low[done]);
+            }
+            if (low[done] == index[done]) {
+                std::uint32_t w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    component[w] = count;
+                } while (w != done);
+                count++;
+            }
+        }
+    }
+
+    Components<std::vector<std::uint32_t>> result;
+    result.component = std::move(component);
+    result.count = components_detail::relabel(result.component);
+    return result;
+}
+
+// parallel forward-backward decomposition: after trimming vertices without in- or out-edges, the
+// vertices reached both forwards and backwards from a pivot form its scc and the three leftover
+// sets are independent subproblems, all open subproblems of a round are handled in parallel
+template <Vertex V, Weight W>
+Components<std::vector<std::uint32_t>> strongly_connected_components(const CsrGraph<V, W>& graph, ThreadPool& pool) {
+    using components_detail::NONE;
+
+    const auto n = graph.size();
+    const auto in_edges = graph.transpose();
+    std::vector<std::uint32_t> component(n, NONE);
+    std::atomic<std::uint32_t> count{0};
+
+    // trim: a vertex without remaining in- or out-edges is a singleton scc
+    std::vector<std::size_t> in_degree(n), out_degree(n);
+    std::vector<std::uint32_t> trimmed;
+    for (std::uint32_t u = 0; u < n; ++u) {
+        in_degree[u] = in_edges.degree(u);
+        out_degree[u] = graph.degree(u);
+        if (in_degree[u] == 0 || out_degree[u] == 0) {
+            component[u] = count++;
+            trimmed.push_back(u);
+        }
+    }
+    while (!trimmed.empty()) {
+        const auto u = trimmed.back();
+        trimmed.pop_back();
+        for (const auto v : graph.neighbors(u)) {
+            if (component[v] == NONE && --in_degree[v] == 0) {
+                component[v] = count++;
+                trimmed.push_back(v);
+            }
+        }
+        for (const auto v : in_edges.neighbors(u)) {
+            if (component[v] == NONE && --out_degree[v] == 0) {
+                component[v] = count++;
+                trimmed.push_back(v);
+            }
+        }
+    }
+
+    // subproblem ids are never reused, so the reach marks need no clearing between rounds
+    std::vector<std::uint32_t> color(n, 0);
+    std::vector<std::uint32_t> forward(n, NONE), backward(n, NONE);
+    std::atomic<std::uint32_t> next_color{1};
+
+    std::vector<std::vector<std::uint32_t>> open(1);
+    for (std::uint32_t u = 0; u < n; ++u) {
+        if (component[u] == NONE) {
+            open[0].push_back(u);
+        }
+    }
+    if (open[0].empty()) {
+        open.clear();
+    }
+
+    struct Slot {
+        std::vector<std::vector<std::uint32_t>> created;
+        std::vector<std::uint32_t> queue;
+    };
+    std::vector<Slot> slots(pool.size());
+
+    // marks every vertex of subproblem `c` reachable from `pivot` along `edges`
+    auto reach = [&](const CsrGraph<V, W>& edges, std::vector<std::uint32_t>& mark, std::uint32_t c, std::uint32_t pivot, std::vector<std::uint32_t>& queue) {
+        queue.assign(1, pivot);
+        mark[pivot] = c;
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            for (const auto v : edges.neighbors(queue[head])) {
+                if (color[v] == c && component[v] == NONE && mark[v] != c) {
+                    mark[v] = c;
+                    queue.push_back(v);
+                }
+            }
+        }
+    };
+
+    while (!open.empty()) {
+        for (auto& slot : slots) {
+            slot.created.clear();
+        }
+
+        // a worker only writes marks and components of the vertices of its own subproblem,
+        // recoloring is deferred until every subproblem of the round is done
+        pool.parallel_for(open.size(), [&](std::size_t task, std::size_t s) {
+            auto& slot = slots[s];
+            const auto& vertices = open[task];
+            const auto c = color[vertices.front()];
+            const auto pivot = vertices.front();
+
+            reach(graph, forward, c, pivot, slot.queue);
+            reach(in_edges, backward, c, pivot, slot.queue);
+
+            const auto scc = count.fetch_add(1);
+            std::vector<std::uint32_t> forward_only, backward_only, rest;
+            for (const auto v : vertices) {
+                const bool f = forward[v] == c;
+                const bool b = backward[v] == c;
+                if (f && b) {
+                    component[v] = scc;
+                } else if (f) {
+                    forward_only.push_back(v);
+                } else if (b) {
+                    backward_only.push_back(v);
+                } else {
+                    rest.push_back(v);
+                }
+            }
+            for (auto* part : {&forward_only, &backward_only, &rest}) {
+                if (!part->empty()) {
+                    slot.created.push_back(std::move(*part));
+                }
+            }
+        });
+
+        std::vector<std::vector<std::uint32_t>> created;
+        for (auto& slot : slots) {
+            for (auto& part : slot.created) {
+                created.push_back(std::move(part));
+            }
+        }
+        for (const auto& part : created) {
+            const auto c = next_color++;
+            for (const auto v : part) {
+                color[v] = c;
+            }
+        }
+        open = std::move(created);
+    }
+
+    Components<std::vector<std::uint32_t>> result;
+    result.component = std::move(component);
+    result.count = components_detail::relabel(result.component);
+    return result;
+}
+
+// generic entry points, any representation is converted to CSR once through the Graph interface
+template <Vertex V, Weight W>
+Components<std::unordered_map<V, std::uint32_t>> weakly_connected_components(const Graph<V, W>& graph, ThreadPool* pool = nullptr) {
+    const CsrGraph<V, W> csr(graph);
+    return components_detail::to_labels(csr, weakly_connected_components(csr, pool));
+}
+
+template <Vertex V, Weight W>
+Components<std::unordered_map<V, std::uint32_t>> strongly_connected_components(const Graph<V, W>& graph) {
+    const CsrGraph<V, W> csr(graph);
+    return components_detail::to_labels(csr, strongly_connected_components(csr));
+}
+
+template <Vertex V, Weight W>
+Components<std::unordered_map<V, std::uint32_t>> strongly_connected_components(const Graph<V, W>& graph, ThreadPool& pool) {
+    const CsrGraph<V, W> csr(graph);
+    return components_detail::to_labels(csr, strongly_connected_components(csr, pool));
+}
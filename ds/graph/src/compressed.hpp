@@ -0,0 +1,562 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+#include "csr.hpp"
+
+struct CompressionOptions {
+    bool quantize_weights = false;     // floating point weights become 16-bit steps between min and max, lossy
+    bool dense_labels = false;         // integral labels 0..n-1 double as ids, no label lookup table is kept
+};
+
+namespace compressed_detail {
+    // group varint: a tag byte holding four 2-bit lengths, then four 1-4 byte little endian values
+    constexpr std::size_t GROUP = 4;
+    // decoders load 16 bytes past a tag, so the byte stream carries this much zero padding
+    constexpr std::size_t PADDING = 16;
+
+    inline std::size_t byte_length(std::uint32_t value) {
+        return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+    }
+
+    // count <= GROUP values, the rest of the group is padded with zeros
+    inline void write_group(std::vector<std::uint8_t>& out, const std::uint32_t* values, std::size_t count) {
+        const auto tag_at = out.size();
+        out.push_back(0);
+        std::uint8_t tag = 0;
+        for (std::size_t k = 0; k < GROUP; ++k) {
+            const auto value = k < count ? values[k] : 0;
+            const auto length = byte_length(value);
+            tag |= static_cast<std::uint8_t>((length - 1) << (2 * k));
+            for (std::size_t b = 0; b < length; ++b) {
+                out.push_back(static_cast<std::uint8_t>(value >> (8 * b)));
+            }
+        }
+        out[tag_at] = tag;
+    }
+
+    struct GroupTables {
+        std::array<std::uint8_t, 256> length{};                   // data bytes after the tag
+        std::array<std::array<std::uint8_t, 16>, 256> shuffle{};  // pshufb mask, 0x80 zeroes a byte
+    };
+
+    inline constexpr GroupTables GROUP_TABLES = [] {
+        GroupTables tables{};
+        for (std::size_t tag = 0; tag < 256; ++tag) {
+            std::uint8_t at = 0;
+            for (std::size_t k = 0; k < GROUP; ++k) {
+                const auto length = ((tag >> (2 * k)) & 3) + 1;
+                for (std::size_t b = 0; b < 4; ++b) {
+                    tables.shuffle[tag][4 * k + b] = b < length ? static_cast<std::uint8_t>(at + b) : 0x80;
+                }
+                at = static_cast<std::uint8_t>(at + length);
+            }
+            tables.length[tag] = at;
+        }
+        return tables;
+    }();
+
+    // with ssse3 a whole group is one unaligned load and one byte shuffle
+    inline void read_group(const std::uint8_t*& p, std::uint32_t* values) {
+        const auto tag = *p++;
+#if defined(__SSSE3__)
+        const auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const auto mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(GROUP_TABLES.shuffle[tag].data()));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values), _mm_shuffle_epi8(data, mask));
+        p += GROUP_TABLES.length[tag];
+#else
+        for (std::size_t k = 0; k < GROUP; ++k) {
+            const std::size_t length = ((tag >> (2 * k)) & 3) + 1;
+            std::uint32_t value = 0;
+            for (std::size_t b = 0; b < length; ++b) {
+                value |= static_cast<std::uint32_t>(p[b]) << (8 * b);
+            }
+            values[k] = value;
+            p += length;
+        }
+#endif
+    }
+
+    // the first target of a row is stored relative to the row id, wrapping in 32 bits
+    inline std::uint32_t zigzag(std::uint32_t from, std::uint32_t to) {
+        const auto delta = static_cast<std::int32_t>(to - from);
+        return (static_cast<std::uint32_t>(delta) << 1) ^ static_cast<std::uint32_t>(delta >> 31);
+    }
+
+    inline std::uint32_t unzigzag(std::uint32_t value) {
+        return (value >> 1) ^ (0u - (value & 1));
+    }
+
+    inline unsigned code_width(std::uint64_t range) {
+        if (range <= std::numeric_limits<std::uint8_t>::max()) {
+            return 1;
+        }
+        if (range <= std::numeric_limits<std::uint16_t>::max()) {
+            return 2;
+        }
+        if (range <= std::numeric_limits<std::uint32_t>::max()) {
+            return 4;
+        }
+        return 8;
+    }
+
+    // id of an integral label when it lies in [0, bound)
+    template <std::integral V>
+    std::optional<std::uint32_t> dense_id(const V& vtx, std::uint64_t bound) {
+        if constexpr (std::is_signed_v<V>) {
+            if (vtx < 0) {
+                return std::nullopt;
+            }
+        }
+        if (static_cast<std::uint64_t>(vtx) >= bound) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint32_t>(vtx);
+    }
+
+    // csr shaped graphs whose rows can be encoded in place, CsrGraph and MappedGraph
+    template <typename S, typename V, typename W>
+    concept RowSource = requires (const S& source, std::uint32_t id) {
+        { source.size() } -> std::convertible_to<std::uint32_t>;
+        { source.edge_count() } -> std::convertible_to<std::size_t>;
+        { source.label(id) } -> std::convertible_to<V>;
+        { source.neighbors(id) } -> std::convertible_to<std::span<const std::uint32_t>>;
+        { source.neighbor_weights(id) } -> std::convertible_to<std::span<const W>>;
+    };
+}
+
+// immutable compressed adjacency: every sorted row is stored as group varints, the first target as a
+// zigzag offset from the row's own id and the rest as gaps, so rows of a well ordered graph take
+// little more than one byte per edge. weights live in a separate array, integral weights as the narrowest unsigned
+// offset from the minimum weight (lossless), floating point weights optionally quantized to 16 bits.
+// rows are encoded one at a time straight from the source, so nothing but the result is allocated
+template <Vertex V, Weight W>
+class CompressedGraph : public Graph<V, W> {
+    std::vector<V> labels;
+    std::unordered_map<V, std::uint32_t> ids;  // empty with dense labels
+    bool dense = false;
+    std::vector<std::size_t> edge_offsets{0};
+    std::vector<std::size_t> byte_offsets{0};
+    std::vector<std::uint8_t> bytes;
+
+    // weight i is base + code(i) * step when width > 0, raw_weights[i] otherwise
+    unsigned width = 0;
+    std::vector<std::uint8_t> codes;
+    std::vector<W> raw_weights;
+    W base{};
+    double step = 1.0;
+
+public:
+    using id_type = std::uint32_t;
+
+    // a MappedGraph is encoded off the mapping without a heap copy of its arrays
+    template <typename Source>
+        requires compressed_detail::RowSource<Source, V, W>
+    explicit CompressedGraph(const Source& graph, const CompressionOptions& options = {}) {
+        encode(graph, options);
+    }
+
+    // with dense labels the edges have to be sorted by source and target and are encoded in a
+    // single pass, otherwise they go through a temporary CsrGraph
+    explicit CompressedGraph(const std::vector<Edge<V, W>>& edges, const CompressionOptions& options = {}) {
+        if (options.dense_labels) {
+            encode_sorted(edges, options);
+        } else {
+            encode(CsrGraph<V, W>(edges), options);
+        }
+    }
+
+    bool add_vertex(const V&) override {
+        throw std::runtime_error("CompressedGraph is immutable");
+    }
+
+    bool remove_vertex(const V&) override {
+        throw std::runtime_error("CompressedGraph is immutable");
+    }
+
+    bool has_vertex(const V& vtx) const override {
+        return index_of(vtx).has_value();
+    }
+
+    size_t vertex_count() const override {
+        return labels.size();
+    }
+
+    std::vector<V> get_vertices() const override {
+        return labels;
+    }
+
+    bool add_edge(const Edge<V, W>&) override {
+        throw std::runtime_error("CompressedGraph is immutable");
+    }
+
+    bool remove_edge(const V&, const V&) override {
+        throw std::runtime_error("CompressedGraph is immutable");
+    }
+
+    bool has_edge(const V& from, const V& to) const override {
+        return get_weight(from, to).has_value();
+    }
+
+    std::optional<Edge<V, W>> get_edge(const V& from, const V& to) const override {
+        const auto weight = get_weight(from, to);
+        if (!weight) {
+            return std::nullopt;
+        }
+        return Edge<V, W>{from, to, *weight};
+    }
+
+    // rows are sorted, so the scan stops at the first target past `to`
+    std::optional<W> get_weight(const V& from, const V& to) const override {
+        const auto from_id = index_of(from);
+        const auto to_id = index_of(to);
+        if (!from_id || !to_id) {
+            return std::nullopt;
+        }
+        std::optional<W> result;
+        for_each_neighbor(*from_id, [&](std::uint32_t target, const W& weight) {
+            if (target == *to_id && !result) {
+                result = weight;
+            }
+            return target >= *to_id;
+        });
+        return result;
+    }
+
+    std::vector<Edge<V, W>> get_edges() const override {
+        std::vector<Edge<V, W>> result;
+        result.reserve(edge_count());
+        for (std::uint32_t u = 0; u < size(); ++u) {
+            append_row(u, result);
+        }
+        return result;
+    }
+
+    std::optional<std::vector<Edge<V, W>>> get_edges(const V& vtx) const override {
+        const auto id = index_of(vtx);
+        if (!id) {
+            return std::nullopt;
+        }
+        std::vector<Edge<V, W>> result;
+        result.reserve(degree(*id));
+        append_row(*id, result);
+        return std::make_optional(result);
+    }
+
+    // dense id access
+    std::uint32_t size() const {
+        return static_cast<std::uint32_t>(labels.size());
+    }
+
+    std::size_t edge_count() const {
+        return edge_offsets.back();
+    }
+
+    std::optional<std::uint32_t> index_of(const V& vtx) const {
+        if constexpr (std::integral<V>) {
+            if (dense) {
+                return compressed_detail::dense_id(vtx, labels.size());
+            }
+        }
+        const auto it = ids.find(vtx);
+        if (it == ids.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    const V& label(std::uint32_t id) const {
+        return labels[id];
+    }
+
+    std::size_t degree(std::uint32_t id) const {
+        return edge_offsets[id + 1] - edge_offsets[id];
+    }
+
+    // GraphView access, neighbors come from for_each_neighbor below
+    std::size_t id_bound() const {
+        return labels.size();
+    }
+
+    template <typename F>
+    void for_each_vertex(F&& fn) const {
+        for (std::uint32_t id = 0; id < size(); ++id) {
+            fn(id);
+        }
+    }
+
+    // fn(target, weight) for every out-edge of `id` in increasing target order, a fn returning
+    // bool stops the row early by returning true
+    template <typename F>
+    void for_each_neighbor(std::uint32_t id, F&& fn) const {
+        switch (width) {
+        case 0:
+            return decode_row(id, fn, [&](std::size_t i) {
+                return raw_weights[i];
+            });
+        case 1:
+            return decode_row(id, fn, [&](std::size_t i) {
+                return weight_from(codes[i]);
+            });
+        case 2:
+            return decode_row(id, fn, [&](std::size_t i) {
+                return weight_from(code_at<std::uint16_t>(i));
+            });
+        case 4:
+            return decode_row(id, fn, [&](std::size_t i) {
+                return weight_from(code_at<std::uint32_t>(i));
+            });
+        default:
+            return decode_row(id, fn, [&](std::size_t i) {
+                return weight_from(code_at<std::uint64_t>(i));
+            });
+        }
+    }
+
+    // heap bytes of the adjacency, weights, labels and label lookup table. the table's buckets and
+    // nodes are estimated, a node being the entry plus a next pointer and a cached hash
+    std::size_t encoded_bytes() const {
+        return bytes.size()
+            + codes.size()
+            + raw_weights.size() * sizeof(W)
+            + (edge_offsets.size() + byte_offsets.size()) * sizeof(std::size_t)
+            + labels.size() * sizeof(V)
+            + ids.bucket_count() * sizeof(void*)
+            + ids.size() * (sizeof(std::pair<const V, std::uint32_t>) + sizeof(void*) + sizeof(std::size_t));
+    }
+
+private:
+    template <typename Source>
+    void encode(const Source& graph, const CompressionOptions& options) {
+        const auto n = graph.size();
+        labels.reserve(n);
+        for (std::uint32_t id = 0; id < n; ++id) {
+            labels.push_back(graph.label(id));
+        }
+        index_labels(options);
+
+        begin_rows(graph.edge_count());
+        for (std::uint32_t u = 0; u < n; ++u) {
+            append_row(u, graph.neighbors(u));
+        }
+        finish_rows();
+
+        encode_weights(graph.edge_count(), [&](auto&& fn) {
+            for (std::uint32_t u = 0; u < n; ++u) {
+                for (const auto& weight : graph.neighbor_weights(u)) {
+                    fn(weight);
+                }
+            }
+        }, options);
+    }
+
+    void encode_sorted(const std::vector<Edge<V, W>>& edges, const CompressionOptions& options) {
+        using namespace compressed_detail;
+        if constexpr (!std::integral<V>) {
+            throw std::invalid_argument("dense labels need an integral vertex type");
+        } else {
+            constexpr auto LIMIT = std::uint64_t{std::numeric_limits<std::uint32_t>::max()};
+            std::uint64_t n = 0;
+            for (std::size_t e = 0; e < edges.size(); ++e) {
+                const auto& edge = edges[e];
+                if (!dense_id(edge.from, LIMIT) || !dense_id(edge.to, LIMIT)) {
+                    throw std::invalid_argument("dense labels must lie in [0, 2^32 - 1)");
+                }
+                if (e > 0 && (edge.from < edges[e - 1].from || (edge.from == edges[e - 1].from && edge.to < edges[e - 1].to))) {
+                    throw std::invalid_argument("dense labels need edges sorted by source and target");
+                }
+                n = std::max({n, static_cast<std::uint64_t>(edge.from) + 1, static_cast<std::uint64_t>(edge.to) + 1});
+            }
+            labels.resize(n);
+            std::iota(labels.begin(), labels.end(), V{0});
+            dense = true;
+
+            begin_rows(edges.size());
+            std::vector<std::uint32_t> row;
+            for (std::size_t u = 0, e = 0; u < n; ++u) {
+                row.clear();
+                for (; e < edges.size() && static_cast<std::uint64_t>(edges[e].from) == u; ++e) {
+                    row.push_back(static_cast<std::uint32_t>(edges[e].to));
+                }
+                append_row(static_cast<std::uint32_t>(u), row);
+            }
+            finish_rows();
+
+            encode_weights(edges.size(), [&](auto&& fn) {
+                for (const auto& edge : edges) {
+                    fn(edge.weight);
+                }
+            }, options);
+        }
+    }
+
+    void index_labels(const CompressionOptions& options) {
+        if (!options.dense_labels) {
+            ids.reserve(labels.size());
+            for (std::uint32_t id = 0; id < labels.size(); ++id) {
+                ids.emplace(labels[id], id);
+            }
+            return;
+        }
+        if constexpr (std::integral<V>) {
+            for (std::uint32_t id = 0; id < labels.size(); ++id) {
+                if (labels[id] != static_cast<V>(id)) {
+                    throw std::invalid_argument("dense labels need label(id) == id");
+                }
+            }
+            dense = true;
+        } else {
+            throw std::invalid_argument("dense labels need an integral vertex type");
+        }
+    }
+
+    void begin_rows(std::size_t edge_count) {
+        edge_offsets.assign(labels.size() + 1, 0);
+        byte_offsets.assign(labels.size() + 1, 0);
+        bytes.reserve(edge_count * 2 + compressed_detail::PADDING);
+    }
+
+    // rows arrive in id order, targets are checked since a mapped file only vouches for its offsets
+    void append_row(std::uint32_t u, std::span<const std::uint32_t> row) {
+        using namespace compressed_detail;
+        std::array<std::uint32_t, GROUP> values{};
+        for (std::size_t i = 0; i < row.size(); i += GROUP) {
+            const auto count = std::min(GROUP, row.size() - i);
+            for (std::size_t k = 0; k < count; ++k) {
+                const auto at = i + k;
+                if (row[at] >= labels.size() || (at > 0 && row[at] < row[at - 1])) {
+                    throw std::invalid_argument("rows must be sorted with targets below the vertex count");
+                }
+                values[k] = at == 0 ? zigzag(u, row[0]) : row[at] - row[at - 1];
+            }
+            write_group(bytes, values.data(), count);
+        }
+        edge_offsets[u + 1] = edge_offsets[u] + row.size();
+        byte_offsets[u + 1] = bytes.size();
+    }
+
+    void finish_rows() {
+        bytes.resize(bytes.size() + compressed_detail::PADDING, 0);
+        bytes.shrink_to_fit();
+    }
+
+    // for_each_weight(fn) hands every weight in edge order to fn, once for the range and once to
+    // write the codes
+    template <typename F>
+    void encode_weights(std::size_t count, F&& for_each_weight, const CompressionOptions& options) {
+        using namespace compressed_detail;
+        if (count == 0) {
+            return;
+        }
+        auto copy_raw = [&] {
+            raw_weights.reserve(count);
+            for_each_weight([&](const W& weight) {
+                raw_weights.push_back(weight);
+            });
+        };
+        if constexpr (std::integral<W> || std::floating_point<W>) {
+            auto low = std::numeric_limits<W>::max();
+            auto high = std::numeric_limits<W>::lowest();
+            for_each_weight([&](const W& weight) {
+                low = std::min(low, weight);
+                high = std::max(high, weight);
+            });
+            base = low;
+
+            std::size_t i = 0;
+            if constexpr (std::integral<W>) {
+                width = code_width(static_cast<std::uint64_t>(high) - static_cast<std::uint64_t>(low));
+                codes.resize(count * width);
+                for_each_weight([&](const W& weight) {
+                    const auto code = static_cast<std::uint64_t>(weight) - static_cast<std::uint64_t>(base);
+                    std::memcpy(codes.data() + i++ * width, &code, width); // little endian
+                });
+            } else {
+                if (!options.quantize_weights) {
+                    return copy_raw();
+                }
+                constexpr auto LEVELS = std::numeric_limits<std::uint16_t>::max();
+                width = 2;
+                step = high > low ? static_cast<double>(high - low) / LEVELS : 1.0;
+                codes.resize(count * width);
+                for_each_weight([&](const W& weight) {
+                    const auto code = static_cast<std::uint16_t>(std::min<double>(LEVELS, (weight - base) / step + 0.5));
+                    std::memcpy(codes.data() + i++ * width, &code, width);
+                });
+            }
+        } else {
+            copy_raw();
+        }
+    }
+
+    template <typename Code>
+    Code code_at(std::size_t i) const {
+        Code code{};
+        std::memcpy(&code, codes.data() + i * sizeof(Code), sizeof(Code));
+        return code;
+    }
+
+    W weight_from(std::uint64_t code) const {
+        if constexpr (std::integral<W>) {
+            return static_cast<W>(static_cast<std::uint64_t>(base) + code);
+        } else if constexpr (std::floating_point<W>) {
+            return static_cast<W>(base + code * step);
+        } else {
+            return base;
+        }
+    }
+
+    template <typename F, typename G>
+    void decode_row(std::uint32_t id, F& fn, G&& weight_at) const {
+        using namespace compressed_detail;
+        const auto* p = bytes.data() + byte_offsets[id];
+        const auto begin = edge_offsets[id];
+        const auto end = edge_offsets[id + 1];
+        if (begin == end) {
+            return;
+        }
+        // the first delta is zigzag coded against the row id, later ones are plain gaps
+        alignas(16) std::uint32_t values[GROUP];
+        read_group(p, values);
+        values[0] = unzigzag(values[0]);
+        auto target = id;
+        for (auto i = begin;;) {
+            for (std::size_t k = 0; k < GROUP; ++k) {
+                target += values[k];
+                if constexpr (std::is_same_v<std::invoke_result_t<F&, std::uint32_t, W>, bool>) {
+                    if (fn(target, weight_at(i))) {
+                        return;
+                    }
+                } else {
+                    fn(target, weight_at(i));
+                }
+                if (++i == end) {
+                    return;
+                }
+            }
+            read_group(p, values);
+        }
+    }
+
+    void append_row(std::uint32_t from, std::vector<Edge<V, W>>& out) const {
+        for_each_neighbor(from, [&](std::uint32_t target, const W& weight) {
+            out.push_back({labels[from], labels[target], weight});
+        });
+    }
+};
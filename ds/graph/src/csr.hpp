@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <unordered_map>
+
+#include "graph.hpp"
+
+// immutable compressed sparse row graph, vertices are interned into dense 32-bit ids in order of
+// first appearance and every row is sorted by target id
+template <Vertex V, Weight W>
+class CsrGraph : public Graph<V, W> {
+    std::vector<V> labels;
+    std::unordered_map<V, std::uint32_t> ids;
+    std::vector<std::size_t> offsets{0};
+    std::vector<std::uint32_t> targets;
+    std::vector<W> weights;
+
+    std::uint32_t intern(const V& vtx) {
+        const auto [it, inserted] = ids.try_emplace(vtx, static_cast<std::uint32_t>(labels.size()));
+        if (inserted) {
+            labels.push_back(vtx);
+        }
+        return it->second;
+    }
+
+    void build(const std::vector<Edge<V, W>>& edges) {
+        std::vector<std::uint32_t> from_ids(edges.size());
+        std::vector<std::uint32_t> to_ids(edges.size());
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            from_ids[e] = intern(edges[e].from);
+            to_ids[e] = intern(edges[e].to);
+        }
+
+        // counting sort by source
+        offsets.assign(labels.size() + 1, 0);
+        for (const auto from : from_ids) {
+            offsets[from + 1]++;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        std::vector<std::size_t> order(edges.size());
+        auto fill = offsets;
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            order[fill[from_ids[e]]++] = e;
+        }
+        for (std::size_t u = 0; u < labels.size(); ++u) {
+            std::sort(order.begin() + offsets[u], order.begin() + offsets[u + 1], [&](std::size_t a, std::size_t b) {
+                return to_ids[a] < to_ids[b];
+            });
+        }
+
+        targets.resize(edges.size());
+        weights.resize(edges.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            targets[i] = to_ids[order[i]];
+            weights[i] = edges[order[i]].weight;
+        }
+    }
+
+public:
+    using id_type = std::uint32_t;
+
+    CsrGraph() = default;
+    ~CsrGraph() = default;
+
+    CsrGraph(const std::vector<Edge<V, W>>& edges) {
+        build(edges);
+    }
+
+    // keeps isolated vertices of `graph`
+    explicit CsrGraph(const Graph<V, W>& graph) {
+        for (const auto& vtx : graph.get_vertices()) {
+            intern(vtx);
+        }
+        build(graph.get_edges());
+    }
+
+    // adopts prebuilt arrays, rows have to be sorted by target
+    CsrGraph(
+        std::vector<V> vertices,
+        std::vector<std::size_t> row_offsets,
+        std::vector<std::uint32_t> row_targets,
+        std::vector<W> row_weights
+    ) : labels(std::move(vertices)),
+        offsets(std::move(row_offsets)),
+        targets(std::move(row_targets)),
+        weights(std::move(row_weights))
+    {
+        if (offsets.size() != labels.size() + 1 || targets.size() != offsets.back() || weights.size() != targets.size()) {
+            throw std::invalid_argument("CsrGraph arrays do not describe a graph");
+        }
+        ids.reserve(labels.size());
+        for (std::size_t i = 0; i < labels.size(); ++i) {
+            ids.emplace(labels[i], static_cast<std::uint32_t>(i));
+        }
+    }
+
+    bool add_vertex(const V&) override {
+        throw std::runtime_error("CsrGraph is immutable");
+    }
+
+    bool remove_vertex(const V&) override {
+        throw std::runtime_error("CsrGraph is immutable");
+    }
+
+    bool has_vertex(const V& vtx) const override {
+        return ids.contains(vtx);
+    }
+
+    size_t vertex_count() const override {
+        return labels.size();
+    }
+
+    std::vector<V> get_vertices() const override {
+        return labels;
+    }
+
+    bool add_edge(const Edge<V, W>&) override {
+        throw std::runtime_error("CsrGraph is immutable");
+    }
+
+    bool remove_edge(const V&, const V&) override {
+        throw std::runtime_error("CsrGraph is immutable");
+    }
+
+    bool has_edge(const V& from, const V& to) const override {
+        return find(from, to).has_value();
+    }
+
+    std::optional<Edge<V, W>> get_edge(const V& from, const V& to) const override {
+        const auto pos = find(from, to);
+        if (!pos) {
+            return std::nullopt;
+        }
+        return Edge<V, W>{from, to, weights[*pos]};
+    }
+
+    std::optional<W> get_weight(const V& from, const V& to) const override {
+        const auto pos = find(from, to);
+        if (!pos) {
+            return std::nullopt;
+        }
+        return weights[*pos];
+    }
+
+    std::vector<Edge<V, W>> get_edges() const override {
+        std::vector<Edge<V, W>> result;
+        result.reserve(targets.size());
+        for (std::uint32_t u = 0; u < size(); ++u) {
+            append_row(u, result);
+        }
+        return result;
+    }
+
+    std::optional<std::vector<Edge<V, W>>> get_edges(const V& vtx) const override {
+        const auto id = index_of(vtx);
+        if (!id) {
+            return std::nullopt;
+        }
+        std::vector<Edge<V, W>> result;
+        result.reserve(degree(*id));
+        append_row(*id, result);
+        return std::make_optional(result);
+    }
+
+    // dense id access
+    std::uint32_t size() const {
+        return static_cast<std::uint32_t>(labels.size());
+    }
+
+    std::size_t edge_count() const {
+        return targets.size();
+    }
+
+    std::optional<std::uint32_t> index_of(const V& vtx) const {
+        const auto it = ids.find(vtx);
+        if (it == ids.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    const V& label(std::uint32_t id) const {
+        return labels[id];
+    }
+
+    std::size_t degree(std::uint32_t id) const {
+        return offsets[id + 1] - offsets[id];
+    }
+
+    std::span<const std::uint32_t> neighbors(std::uint32_t id) const {
+        return {targets.data() + offsets[id], degree(id)};
+    }
+
+    std::span<const W> neighbor_weights(std::uint32_t id) const {
+        return {weights.data() + offsets[id], degree(id)};
+    }
+
+    // GraphView access
+    std::size_t id_bound() const {
+        return labels.size();
+    }
+
+    template <typename F>
+    void for_each_vertex(F&& fn) const {
+        for (std::uint32_t id = 0; id < size(); ++id) {
+            fn(id);
+        }
+    }
+
+    template <typename F>
+    void for_each_neighbor(std::uint32_t id, F&& fn) const {
+        for (auto i = offsets[id]; i < offsets[id + 1]; ++i) {
+            fn(targets[i], weights[i]);
+        }
+    }
+
+    const std::vector<std::size_t>& row_offsets() const {
+        return offsets;
+    }
+
+    const std::vector<std::uint32_t>& column_targets() const {
+        return targets;
+    }
+
+    const std::vector<W>& edge_weights() const {
+        return weights;
+    }
+
+    // same vertex ids with every edge reversed, row u of the result lists the in-neighbors of u
+    CsrGraph transpose() const {
+        std::vector<std::size_t> t_offsets(labels.size() + 1, 0);
+        for (const auto to : targets) {
+            t_offsets[to + 1]++;
+        }
+        std::partial_sum(t_offsets.begin(), t_offsets.end(), t_offsets.begin());
+
+        // sources are visited in increasing order, so every transposed row comes out sorted
+        std::vector<std::uint32_t> t_targets(targets.size());
+        std::vector<W> t_weights(weights.size());
+        auto fill = t_offsets;
+        for (std::uint32_t u = 0; u < size(); ++u) {
+            for (auto i = offsets[u]; i < offsets[u + 1]; ++i) {
+                const auto pos = fill[targets[i]]++;
+                t_targets[pos] = u;
+                t_weights[pos] = weights[i];
+            }
+        }
+        return CsrGraph(labels, std::move(t_offsets), std::move(t_targets), std::move(t_weights));
+    }
+
+private:
+    std::optional<std::size_t> find(const V& from, const V& to) const {
+        const auto from_id = index_of(from);
+        const auto to_id = index_of(to);
+        if (!from_id || !to_id) {
+            return std::nullopt;
+        }
+        const auto row = neighbors(*from_id);
+        const auto it = std::lower_bound(row.begin(), row.end(), *to_id);
+        if (it == row.end() || *it != *to_id) {
+            return std::nullopt;
+        }
+        return offsets[*from_id] + static_cast<std::size_t>(it - row.begin());
+    }
+
+    void append_row(std::uint32_t from, std::vector<Edge<V, W>>& out) const {
+        for (auto i = offsets[from]; i < offsets[from + 1]; ++i) {
+            out.push_back({labels[from], labels[targets[i]], weights[i]});
+        }
+    }
+};
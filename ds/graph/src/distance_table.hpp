@@ -0,0 +1,70 @@
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "graph.hpp"
+#include "thread_pool.hpp"
+
+// row-major |sources| x |targets| matrix, nullopt where the target is unreachable
+template <Weight W>
+struct DistanceTable {
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::vector<std::optional<W>> values;
+
+    const std::optional<W>& at(std::size_t row, std::size_t col) const {
+        return values[row * cols + col];
+    }
+};
+
+// one dijkstra per source that stops as soon as every distinct target is settled, sources are
+// spread over the pool and every worker keeps its own SearchContext
+template <Vertex V, Weight W>
+DistanceTable<W> distance_table(
+    const Graph<V, W>& graph,
+    const std::vector<V>& sources,
+    const std::vector<V>& targets,
+    ThreadPool& pool
+) {
+    DistanceTable<W> table{sources.size(), targets.size(), {}};
+    table.values.resize(sources.size() * targets.size());
+
+    // a target may be requested in several columns
+    std::unordered_map<V, std::vector<std::size_t>> columns;
+    for (std::size_t col = 0; col < targets.size(); ++col) {
+        columns[targets[col]].push_back(col);
+    }
+    if (columns.empty()) {
+        return table;
+    }
+
+    std::vector<SearchContext<V, W>> contexts(pool.size());
+    pool.parallel_for(sources.size(), [&](std::size_t row, std::size_t slot) {
+        auto& context = contexts[slot];
+        std::size_t remaining = columns.size();
+        graph.dijkstra_visit(sources[row], context, [&](std::size_t id) {
+            const auto it = columns.find(context.label(id));
+            if (it == columns.end()) {
+                return false;
+            }
+            for (const auto col : it->second) {
+                table.values[row * table.cols + col] = context.distance(id);
+            }
+            return --remaining == 0;
+        });
+    });
+    return table;
+}
+
+template <Vertex V, Weight W>
+DistanceTable<W> distance_table(
+    const Graph<V, W>& graph,
+    const std::vector<V>& sources,
+    const std::vector<V>& targets,
+    std::size_t threads = std::thread::hardware_concurrency()
+) {
+    ThreadPool pool(threads);
+    return distance_table(graph, sources, targets, pool);
+}
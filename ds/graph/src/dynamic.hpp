@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "graph.hpp"
+
+// single source shortest paths kept up to date while the graph changes. after a batch only the
+// part of the tree that can have changed is repaired, in the spirit of ramalingam and reps:
+//  - increased or removed tree edges invalidate the subtree below them, those vertices take the
+//    best offer of their in-edges from the rest of the tree as tentative distance
+//  - decreased or inserted edges offer their target a shorter path
+//  - a dijkstra seeded with the touched vertices then settles only what actually moved
+// the affected subtree is a superset of the vertices whose distance grows, equal length
+// alternatives are found again by the seeding instead of being tracked up front.
+// weights must be non-negative, in-edges come from get_in_edges so the graph should keep an in-edge index
+template <Vertex V, Weight W>
+class DynamicShortestPaths {
+public:
+    DynamicShortestPaths(Graph<V, W>& graph, const V& source)
+        : graph(graph), source_vertex(source)
+    {
+        recompute();
+    }
+
+    const V& source() const {
+        return source_vertex;
+    }
+
+    // full dijkstra from the source, drops the maintained tree
+    void recompute() {
+        std::fill(reached.begin(), reached.end(), false);
+        heap.clear();
+        const auto id = intern(source_vertex);
+        reached[id] = true;
+        distances[id] = W{0};
+        parents[id] = id;
+        push(W{0}, id);
+        settle();
+    }
+
+    // applies the batch to the graph and repairs the tree, same result as apply_batch + recompute
+    void apply_batch(const std::vector<EdgeUpdate<V, W>>& updates) {
+        // the last update of every pair decides its effect on the tree
+        std::unordered_map<std::pair<V, V>, std::optional<W>, VertexPairHash<V>> changes;
+        for (const auto& update : updates) {
+            if (update.weight && *update.weight < W{0}) {
+                throw std::invalid_argument("Incremental shortest paths need non-negative weights");
+            }
+            changes.insert_or_assign({update.from, update.to}, update.weight);
+        }
+
+        // tree edges that got heavier or disappeared cut their subtree loose, the walk has to
+        // happen on the old graph since removed tree edges are still needed to find the children
+        std::vector<std::size_t> affected;
+        for (const auto& [pair, weight] : changes) {
+            const auto to = find(pair.second);
+            if (!to || !reached[*to] || parents[*to] == *to) {
+                continue;
+            }
+            const auto& edge = parent_edges[*to];
+            if (edge.from == pair.first && (!weight || *weight > edge.weight)) {
+                reached[*to] = false;
+                affected.push_back(*to);
+            }
+        }
+        for (std::size_t head = 0; head < affected.size(); ++head) {
+            const auto id = affected[head];
+            const auto edges = graph.get_edges(labels[id]);
+            if (!edges) {
+                continue;
+            }
+            for (const auto& edge : *edges) {
+                const auto child = find(edge.to);
+                if (child && reached[*child] && parents[*child] == id) {
+                    reached[*child] = false;
+                    affected.push_back(*child);
+                }
+            }
+        }
+
+        graph.apply_batch(updates);
+        heap.clear();
+
+        for (const auto id : affected) {
+            const auto in_edges = graph.get_in_edges(labels[id]);
+            if (!in_edges) {
+                continue;
+            }
+            for (const auto& edge : *in_edges) {
+                const auto from = find(edge.from);
+                if (from && reached[*from]) {
+                    relax(*from, edge);
+                }
+            }
+        }
+        for (const auto& [pair, weight] : changes) {
+            const auto from = find(pair.first);
+            if (weight && from && reached[*from]) {
+                relax(*from, {pair.first, pair.second, *weight});
+            }
+        }
+        settle();
+    }
+
+    std::optional<W> distance(const V& vtx) const {
+        const auto id = find(vtx);
+        if (!id || !reached[*id]) {
+            return std::nullopt;
+        }
+        return distances[*id];
+    }
+
+    std::optional<std::vector<Edge<V, W>>> path_to(const V& vtx) const {
+        auto id = find(vtx);
+        if (!id || !reached[*id]) {
+            return std::nullopt;
+        }
+        std::vector<Edge<V, W>> path;
+        while (parents[*id] != *id) {
+            path.push_back(parent_edges[*id]);
+            id = parents[*id];
+        }
+        std::reverse(path.begin(), path.end());
+        return std::make_optional(path);
+    }
+
+    ShortestPathTree<V, W> tree() const {
+        ShortestPathTree<V, W> result;
+        for (std::size_t id = 0; id < labels.size(); ++id) {
+            if (!reached[id]) {
+                continue;
+            }
+            result.distances.emplace(labels[id], distances[id]);
+            if (parents[id] != id) {
+                result.parents.emplace(labels[id], parent_edges[id]);
+            }
+        }
+        return result;
+    }
+
+    // vertices settled by the last recompute or repair
+    std::size_t last_settled() const {
+        return settled;
+    }
+
+private:
+    using Node = std::pair<W, std::size_t>;
+
+    Graph<V, W>& graph;
+    V source_vertex;
+
+    std::unordered_map<V, std::size_t> ids;
+    std::vector<V> labels;
+    std::vector<W> distances;
+    std::vector<std::size_t> parents;
+    std::vector<Edge<V, W>> parent_edges;
+    std::vector<bool> reached;
+    std::vector<Node> heap;
+    std::size_t settled = 0;
+
+    std::optional<std::size_t> find(const V& vtx) const {
+        const auto it = ids.find(vtx);
+        if (it == ids.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    std::size_t intern(const V& vtx) {
+        const auto [it, inserted] = ids.try_emplace(vtx, labels.size());
+        if (inserted) {
+            labels.push_back(vtx);
+            distances.push_back(W{});
+            parents.push_back(it->second);
+            parent_edges.push_back({vtx, vtx, W{}});
+            reached.push_back(false);
+        }
+        return it->second;
+    }
+
+    void push(const W& distance, std::size_t id) {
+        heap.push_back({distance, id});
+        std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+    }
+
+    void relax(std::size_t from, const Edge<V, W>& edge) {
+        if (edge.weight < W{0}) {
+            throw std::invalid_argument("Incremental shortest paths need non-negative weights");
+        }
+        const auto candidate = distances[from] + edge.weight;
+        const auto to = intern(edge.to);
+        if (!reached[to] || candidate < distances[to]) {
+            reached[to] = true;
+            distances[to] = candidate;
+            parents[to] = from;
+            parent_edges[to] = edge;
+            push(candidate, to);
+        }
+    }
+
+    void settle() {
+        settled = 0;
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+            const auto [distance, id] = heap.back();
+            heap.pop_back();
+            if (!reached[id] || distance > distances[id]) {
+                continue;
+            }
+            ++settled;
+            const auto edges = graph.get_edges(labels[id]);
+            if (!edges) {
+                continue;
+            }
+            for (const auto& edge : *edges) {
+                relax(id, edge);
+            }
+        }
+    }
+};
@@ -1,26 +1,77 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <numeric>
 #include <unordered_set>
 
 #include "graph.hpp"
 
+// plain list of edges. in indexed mode a hash map of (from, to) pairs answers point queries in O(1)
+// and the positions of the edges grouped by source (offsets per source, counting sorted) serve
+// get_edges(vtx) in O(degree). the grouping is built lazily on first use and dropped by any mutation
 template <Vertex V, Weight W>
 class EdgeListGraph : public Graph<V, W> {
     std::vector<Edge<V, W>> edges;
 
     // map to keep track of the vertex use count
     std::unordered_map<V, std::size_t> vertices;
+
+    bool indexed = false;
+    std::unordered_map<std::pair<V, V>, W, VertexPairHash<V>> pairs;
+
+    // built under the mutex by the first reader, so concurrent const queries stay safe
+    struct SourceIndex {
+        std::unordered_map<V, std::size_t> ids;
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> positions;
+        std::atomic<bool> valid{false};
+        std::mutex mutex;
+
+        SourceIndex() = default;
+
+        // copies start out stale and rebuild on demand
+        SourceIndex(const SourceIndex&) {}
+
+        SourceIndex& operator=(const SourceIndex&) {
+            valid = false;
+            return *this;
+        }
+    };
+    mutable SourceIndex source_index;
+
 public:
+    using id_type = V; // labels double as ids for the GraphView algorithms
+
     EdgeListGraph() = default;
     ~EdgeListGraph() = default;
 
-    EdgeListGraph(const std::vector<Edge<V, W>>& edges)
+    EdgeListGraph(const std::vector<Edge<V, W>>& edges, bool indexed = false)
         : edges(edges)
     {
         for (const auto& edge : edges) {
             vertices[edge.from]++;
             vertices[edge.to]++;
         }
+        set_indexed(indexed);
+    }
+
+    bool is_indexed() const {
+        return indexed;
+    }
+
+    void set_indexed(bool enable) {
+        indexed = enable;
+        pairs.clear();
+        source_index.valid = false;
+        if (!enable) {
+            return;
+        }
+        // duplicates keep the first occurrence, like the linear scans
+        pairs.reserve(edges.size());
+        for (const auto& edge : edges) {
+            pairs.try_emplace({edge.from, edge.to}, edge.weight);
+        }
     }
 
     bool add_vertex(const V&) override {
@@ -56,6 +107,10 @@ public:
         edges.push_back(edge);
         vertices[edge.from]++;
         vertices[edge.to]++;
+        if (indexed) {
+            pairs.emplace(std::pair{edge.from, edge.to}, edge.weight);
+            source_index.valid = false;
+        }
         return true;
     }
 
@@ -73,16 +128,30 @@ public:
         if (--vertices[to] == 0) {
             vertices.erase(to);
         }
+        if (indexed) {
+            pairs.erase({from, to});
+            source_index.valid = false;
+        }
         return true;
     }
 
     bool has_edge(const V& from, const V& to) const override {
+        if (indexed) {
+            return pairs.contains({from, to});
+        }
         return std::any_of(edges.begin(), edges.end(), [from, to](const auto& edge) {
             return edge.from == from && edge.to == to;
         });
     }
 
     std::optional<Edge<V, W>> get_edge(const V& from, const V& to) const override {
+        if (indexed) {
+            const auto it = pairs.find({from, to});
+            if (it == pairs.end()) {
+                return std::nullopt;
+            }
+            return Edge<V, W>{from, to, it->second};
+        }
         const auto it = std::find_if(edges.begin(), edges.end(), [from, to](const Edge<V, W>& edge) {
             if (edge.from == from && edge.to == to) {
                 return true;
@@ -109,11 +178,97 @@ public:
 
     std::optional<std::vector<Edge<V, W>>> get_edges(const V& vtx) const override {
         std::vector<Edge<V, W>> vertex_edges;
+        if (indexed) {
+            const auto& index = sources();
+            const auto it = index.ids.find(vtx);
+            if (it != index.ids.end()) {
+                const auto id = it->second;
+                vertex_edges.reserve(index.offsets[id + 1] - index.offsets[id]);
+                for (auto i = index.offsets[id]; i < index.offsets[id + 1]; ++i) {
+                    vertex_edges.push_back(edges[index.positions[i]]);
+                }
+            }
+            return std::make_optional(vertex_edges);
+        }
         std::copy_if(edges.begin(), edges.end(), std::back_inserter(vertex_edges), [vtx](const auto& edge) {
             return edge.from == vtx;
         });
         return std::make_optional(vertex_edges);
     }
+
+    // GraphView access, a row costs O(degree) in indexed mode and a scan of every edge otherwise
+    std::optional<V> index_of(const V& vtx) const {
+        if (!has_vertex(vtx)) {
+            return std::nullopt;
+        }
+        return vtx;
+    }
+
+    const V& label(const V& vtx) const {
+        return vtx;
+    }
+
+    template <typename F>
+    void for_each_vertex(F&& fn) const {
+        for (const auto& [vtx, count] : vertices) {
+            fn(vtx);
+        }
+    }
+
+    template <typename F>
+    void for_each_neighbor(const V& vtx, F&& fn) const {
+        if (indexed) {
+            const auto& index = sources();
+            const auto it = index.ids.find(vtx);
+            if (it == index.ids.end()) {
+                return;
+            }
+            for (auto i = index.offsets[it->second]; i < index.offsets[it->second + 1]; ++i) {
+                const auto& edge = edges[index.positions[i]];
+                fn(edge.to, edge.weight);
+            }
+            return;
+        }
+        for (const auto& edge : edges) {
+            if (edge.from == vtx) {
+                fn(edge.to, edge.weight);
+            }
+        }
+    }
+
+private:
+    const SourceIndex& sources() const {
+        auto& index = source_index;
+        if (index.valid.load(std::memory_order_acquire)) {
+            return index;
+        }
+        std::lock_guard lock(index.mutex);
+        if (index.valid.load(std::memory_order_relaxed)) {
+            return index;
+        }
+
+        // counting sort of edge positions by source, stable so rows keep insertion order
+        index.ids.clear();
+        index.offsets.assign(1, 0);
+        std::vector<std::size_t> source_of(edges.size());
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            const auto [it, inserted] = index.ids.try_emplace(edges[e].from, index.ids.size());
+            if (inserted) {
+                index.offsets.push_back(0);
+            }
+            source_of[e] = it->second;
+            index.offsets[it->second + 1]++;
+        }
+        std::partial_sum(index.offsets.begin(), index.offsets.end(), index.offsets.begin());
+        index.positions.resize(edges.size());
+        auto fill = index.offsets;
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            index.positions[fill[source_of[e]]++] = e;
+        }
+
+        index.valid.store(true, std::memory_order_release);
+        return index;
+    }
 };
 
 // utility type trait to check if a type is an EdgeListGraph
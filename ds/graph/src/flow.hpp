@@ -0,0 +1,397 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "graph.hpp"
+
+template <Vertex V, Weight W>
+struct MaxFlowResult {
+    W value{};
+    std::vector<Edge<V, W>> flows;  // every input edge carrying flow, the weight is the flow on it
+    std::vector<V> source_side;     // vertices reachable from the source in the final residual graph
+    std::vector<Edge<V, W>> cut;    // input edges leaving the source side, all saturated
+};
+
+// maximum flow over a fixed network, edge weights are capacities. the residual graph is a CSR built
+// once: every input edge owns a forward arc in the row of its source and a zero capacity reverse arc
+// in the row of its target, and each arc stores the index of its pair. self-loops are ignored and
+// parallel edges keep their own arcs.
+// max_flow() runs highest label push-relabel with the gap and global relabel heuristics until the
+// preflow is maximal, then returns the excess left on unreachable vertices to the source so the
+// reported per-edge flows are a valid flow
+template <Vertex V, Weight W>
+class FlowNetwork {
+    static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<V> labels;
+    std::unordered_map<V, std::uint32_t> ids;
+    std::vector<Edge<V, W>> edges;
+    std::vector<std::size_t> arc_of;  // forward arc of every input edge, unused for self-loops
+    std::vector<std::size_t> offsets{0};
+    std::vector<std::uint32_t> heads;
+    std::vector<std::size_t> pairs;
+    std::vector<W> capacity;
+
+    // workspace of the last solve
+    std::vector<W> residual;
+    std::vector<W> excess;
+    std::vector<std::uint32_t> height;
+    std::vector<std::size_t> current;
+    // vertices below height n sit in a doubly linked list per height, active ones also on a stack
+    // per height, so the highest active vertex and the members of a gap are found directly
+    std::vector<std::uint32_t> bucket_head, bucket_next, bucket_prev;
+    std::vector<std::uint32_t> active_head, active_next;
+    std::vector<std::uint32_t> queue;
+    std::uint32_t top_bucket = 0;
+    std::uint32_t top_active = 0;
+    std::size_t work = 0;
+
+    std::uint32_t intern(const V& vtx) {
+        const auto [it, inserted] = ids.try_emplace(vtx, static_cast<std::uint32_t>(labels.size()));
+        if (inserted) {
+            labels.push_back(vtx);
+        }
+        return it->second;
+    }
+
+    void build() {
+        std::vector<std::uint32_t> from_ids(edges.size());
+        std::vector<std::uint32_t> to_ids(edges.size());
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            if (edges[e].weight < W{}) {
+                throw std::invalid_argument("FlowNetwork requires non-negative capacities");
+            }
+            from_ids[e] = intern(edges[e].from);
+            to_ids[e] = intern(edges[e].to);
+        }
+
+        offsets.assign(labels.size() + 1, 0);
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            if (from_ids[e] != to_ids[e]) {
+                offsets[from_ids[e] + 1]++;
+                offsets[to_ids[e] + 1]++;
+            }
+        }
+        for (std::size_t u = 0; u < labels.size(); ++u) {
+            offsets[u + 1] += offsets[u];
+        }
+
+        heads.resize(offsets.back());
+        pairs.resize(offsets.back());
+        capacity.assign(offsets.back(), W{});
+        arc_of.assign(edges.size(), 0);
+        auto fill = offsets;
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            const auto u = from_ids[e];
+            const auto v = to_ids[e];
+            if (u == v) {
+                continue;
+            }
+            const auto forward = fill[u]++;
+            const auto backward = fill[v]++;
+            heads[forward] = v;
+            heads[backward] = u;
+            pairs[forward] = backward;
+            pairs[backward] = forward;
+            capacity[forward] = edges[e].weight;
+            arc_of[e] = forward;
+        }
+    }
+
+    std::uint32_t size() const {
+        return static_cast<std::uint32_t>(labels.size());
+    }
+
+    void push(std::uint32_t u, std::size_t arc, W amount) {
+        residual[arc] = residual[arc] - amount;
+        residual[pairs[arc]] = residual[pairs[arc]] + amount;
+        excess[u] = excess[u] - amount;
+        excess[heads[arc]] = excess[heads[arc]] + amount;
+    }
+
+    void link(std::uint32_t u) {
+        const auto h = height[u];
+        bucket_prev[u] = NONE;
+        bucket_next[u] = bucket_head[h];
+        if (bucket_head[h] != NONE) {
+            bucket_prev[bucket_head[h]] = u;
+        }
+        bucket_head[h] = u;
+        top_bucket = std::max(top_bucket, h);
+    }
+
+    void unlink(std::uint32_t u) {
+        if (bucket_prev[u] != NONE) {
+            bucket_next[bucket_prev[u]] = bucket_next[u];
+        } else {
+            bucket_head[height[u]] = bucket_next[u];
+        }
+        if (bucket_next[u] != NONE) {
+            bucket_prev[bucket_next[u]] = bucket_prev[u];
+        }
+    }
+
+    void activate(std::uint32_t u) {
+        active_next[u] = active_head[height[u]];
+        active_head[height[u]] = u;
+        top_active = std::max(top_active, height[u]);
+    }
+
+    // exact distances to the sink by a reverse bfs over the residual arcs, vertices that cannot
+    // reach it any more are lifted to n and leave the first phase
+    void global_relabel(std::uint32_t source, std::uint32_t sink) {
+        const auto n = size();
+        std::fill(height.begin(), height.end(), n);
+        std::fill(bucket_head.begin(), bucket_head.end(), NONE);
+        std::fill(active_head.begin(), active_head.end(), NONE);
+        top_bucket = 0;
+        top_active = 0;
+        work = 0;
+
+        queue.clear();
+        height[sink] = 0;
+        queue.push_back(sink);
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const auto v = queue[head];
+            link(v);
+            if (v != sink && excess[v] > W{}) {
+                activate(v);
+            }
+            for (auto arc = offsets[v]; arc < offsets[v + 1]; ++arc) {
+                const auto u = heads[arc];
+                if (height[u] == n && u != source && residual[pairs[arc]] > W{}) {
+                    height[u] = height[v] + 1;
+                    queue.push_back(u);
+                }
+            }
+        }
+        for (std::uint32_t u = 0; u < n; ++u) {
+            current[u] = offsets[u];
+        }
+    }
+
+    // pushes the excess of u down admissible arcs, relabels when none is left. returns once u is
+    // inactive or has been lifted out of the first phase
+    void discharge(std::uint32_t u, std::uint32_t sink) {
+        const auto n = size();
+        while (excess[u] > W{}) {
+            for (; current[u] < offsets[u + 1]; ++current[u]) {
+                const auto arc = current[u];
+                const auto v = heads[arc];
+                if (residual[arc] > W{} && height[u] == height[v] + 1) {
+                    const auto amount = std::min(excess[u], residual[arc]);
+                    if (v != sink && excess[v] == W{}) {
+                        activate(v);
+                    }
+                    push(u, arc, amount);
+                    if (excess[u] == W{}) {
+                        return;
+                    }
+                }
+            }
+
+            const auto old_height = height[u];
+            auto new_height = n;
+            for (auto arc = offsets[u]; arc < offsets[u + 1]; ++arc) {
+                if (residual[arc] > W{}) {
+                    new_height = std::min(new_height, height[heads[arc]] + 1);
+                }
+            }
+            work += offsets[u + 1] - offsets[u] + 12;
+            current[u] = offsets[u];
+            unlink(u);
+
+            // gap: u was the last vertex at its height, so nothing above it can reach the sink
+            if (bucket_head[old_height] == NONE) {
+                for (auto h = old_height; h <= top_bucket; ++h) {
+                    for (auto v = bucket_head[h]; v != NONE; v = bucket_next[v]) {
+                        height[v] = n;
+                    }
+                    bucket_head[h] = NONE;
+                    active_head[h] = NONE;
+                }
+                top_bucket = old_height == 0 ? 0 : old_height - 1;
+                height[u] = n;
+                return;
+            }
+            height[u] = new_height;
+            if (new_height >= n) {
+                return;
+            }
+            link(u);
+        }
+    }
+
+    // second phase: excess stranded on vertices cut off from the sink flows back to the source.
+    // heights restart as residual distances to the source and a fifo discharge moves the excess
+    // down them, the sink side is never entered since no stranded vertex reaches it
+    void return_excess(std::uint32_t source, std::uint32_t sink) {
+        const auto n = size();
+        std::fill(height.begin(), height.end(), 2 * n);
+        queue.clear();
+        height[source] = 0;
+        queue.push_back(source);
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const auto v = queue[head];
+            for (auto arc = offsets[v]; arc < offsets[v + 1]; ++arc) {
+                const auto u = heads[arc];
+                if (height[u] == 2 * n && u != sink && residual[pairs[arc]] > W{}) {
+                    height[u] = height[v] + 1;
+                    queue.push_back(u);
+                }
+            }
+        }
+
+        queue.clear();
+        for (std::uint32_t u = 0; u < n; ++u) {
+            current[u] = offsets[u];
+            if (u != source && u != sink && excess[u] > W{}) {
+                queue.push_back(u);
+            }
+        }
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const auto u = queue[head];
+            while (excess[u] > W{}) {
+                if (current[u] == offsets[u + 1]) {
+                    auto new_height = std::numeric_limits<std::uint32_t>::max();
+                    for (auto arc = offsets[u]; arc < offsets[u + 1]; ++arc) {
+                        if (residual[arc] > W{} && heads[arc] != sink) {
+                            new_height = std::min(new_height, height[heads[arc]] + 1);
+                        }
+                    }
+                    height[u] = new_height;
+                    current[u] = offsets[u];
+                }
+                const auto arc = current[u];
+                const auto v = heads[arc];
+                if (residual[arc] > W{} && v != sink && height[u] == height[v] + 1) {
+                    if (v != source && excess[v] == W{}) {
+                        queue.push_back(v);
+                    }
+                    push(u, arc, std::min(excess[u], residual[arc]));
+                } else {
+                    ++current[u];
+                }
+            }
+        }
+    }
+
+public:
+    FlowNetwork(const std::vector<Edge<V, W>>& edges)
+        : edges(edges)
+    {
+        build();
+    }
+
+    // keeps isolated vertices of `graph`
+    explicit FlowNetwork(const Graph<V, W>& graph)
+        : edges(graph.get_edges())
+    {
+        for (const auto& vtx : graph.get_vertices()) {
+            intern(vtx);
+        }
+        build();
+    }
+
+    // nullopt if either endpoint is not in the network, throws for source == sink
+    std::optional<MaxFlowResult<V, W>> max_flow(const V& source, const V& sink) {
+        const auto s_it = ids.find(source);
+        const auto t_it = ids.find(sink);
+        if (s_it == ids.end() || t_it == ids.end()) {
+            return std::nullopt;
+        }
+        if (source == sink) {
+            throw std::invalid_argument("max_flow requires distinct source and sink");
+        }
+        const auto s = s_it->second;
+        const auto t = t_it->second;
+        const auto n = size();
+
+        residual = capacity;
+        excess.assign(n, W{});
+        height.assign(n, 0);
+        current.assign(n, 0);
+        bucket_head.assign(n, NONE);
+        bucket_next.assign(n, NONE);
+        bucket_prev.assign(n, NONE);
+        active_head.assign(n, NONE);
+        active_next.assign(n, NONE);
+
+        for (auto arc = offsets[s]; arc < offsets[s + 1]; ++arc) {
+            if (residual[arc] > W{}) {
+                excess[s] = excess[s] + residual[arc];
+                push(s, arc, residual[arc]);
+            }
+        }
+        global_relabel(s, t);
+
+        // relabel work between two global relabels is bounded by a multiple of the graph size
+        const auto relabel_period = 6 * static_cast<std::size_t>(n) + offsets.back();
+        while (true) {
+            while (top_active > 0 && active_head[top_active] == NONE) {
+                --top_active;
+            }
+            const auto u = active_head[top_active];
+            if (u == NONE) {
+                break;
+            }
+            active_head[top_active] = active_next[u];
+            // stale entries of vertices relabeled, gapped or drained since they were pushed
+            if (height[u] != top_active || excess[u] == W{}) {
+                continue;
+            }
+            discharge(u, t);
+            if (excess[u] > W{} && height[u] < n) {
+                activate(u);
+            }
+            if (work > relabel_period) {
+                global_relabel(s, t);
+            }
+        }
+
+        MaxFlowResult<V, W> result;
+        result.value = excess[t];
+        return_excess(s, t);
+
+        std::vector<bool> reached(n, false);
+        queue.assign(1, s);
+        reached[s] = true;
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const auto u = queue[head];
+            result.source_side.push_back(labels[u]);
+            for (auto arc = offsets[u]; arc < offsets[u + 1]; ++arc) {
+                if (!reached[heads[arc]] && residual[arc] > W{}) {
+                    reached[heads[arc]] = true;
+                    queue.push_back(heads[arc]);
+                }
+            }
+        }
+
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            const auto& edge = edges[e];
+            if (edge.from == edge.to) {
+                continue;
+            }
+            const auto flow = edge.weight - residual[arc_of[e]];
+            if (flow > W{}) {
+                result.flows.push_back({edge.from, edge.to, flow});
+            }
+            if (reached[ids.at(edge.from)] && !reached[ids.at(edge.to)]) {
+                result.cut.push_back(edge);
+            }
+        }
+        return result;
+    }
+};
+
+template <Vertex V, Weight W>
+std::optional<MaxFlowResult<V, W>> max_flow(const Graph<V, W>& graph, const V& source, const V& sink) {
+    FlowNetwork<V, W> network(graph);
+    return network.max_flow(source, sink);
+}
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "csr.hpp"
+#include "thread_pool.hpp"
+
+// random graph generators that write straight into csr arrays without a quadratic bitmap or an
+// intermediate edge set. work is cut into fixed blocks with their own seeded random stream, so a
+// given seed produces the same graph for every pool size
+struct GeneratorOptions {
+    std::uint64_t seed = 280131;
+    int min_weight = 1;                // weights are drawn uniformly from [min_weight, max_weight]
+    int max_weight = 100;
+};
+
+// quadrant probabilities of the recursive matrix, d = 1 - a - b - c
+struct RmatParameters {
+    double a = 0.57;
+    double b = 0.19;
+    double c = 0.19;
+};
+
+namespace generators_detail {
+    constexpr std::size_t BLOCK = 1 << 16;
+
+    // splitmix64 finalizer
+    inline std::uint64_t mix(std::uint64_t x) {
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    inline std::mt19937_64 stream(std::uint64_t seed, std::uint64_t block) {
+        return std::mt19937_64(mix(seed ^ mix(block)));
+    }
+
+    inline void check_vertex_count(std::size_t n) {
+        if (n >= std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("Too many vertices for 32-bit ids");
+        }
+    }
+
+    inline void check_weights(const GeneratorOptions& options) {
+        if (options.min_weight > options.max_weight) {
+            throw std::invalid_argument("min_weight is larger than max_weight");
+        }
+    }
+
+    template <std::integral V>
+    std::vector<V> identity_labels(std::size_t n, ThreadPool* pool) {
+        std::vector<V> labels(n);
+        const auto blocks = (n + BLOCK - 1) / BLOCK;
+        parallel_chunks(pool, blocks, 1, [&](std::size_t block, std::size_t) {
+            const auto end = std::min(n, (block + 1) * BLOCK);
+            for (auto i = block * BLOCK; i < end; ++i) {
+                labels[i] = static_cast<V>(i);
+            }
+        });
+        return labels;
+    }
+
+    // rows generated in order by independent blocks: block b owns rows [first[b], first[b + 1]),
+    // counts[u + 1] holds the degree of u and the block buffers hold the rows back to back
+    template <std::integral V, Weight W>
+    CsrGraph<V, W> assemble(
+        const std::vector<std::size_t>& first,
+        std::vector<std::size_t> counts,
+        std::vector<std::vector<std::uint32_t>>& block_targets,
+        std::vector<std::vector<W>>& block_weights,
+        ThreadPool* pool
+    ) {
+        const auto n = counts.size() - 1;
+        std::partial_sum(counts.begin(), counts.end(), counts.begin());
+        std::vector<std::uint32_t> targets(counts.back());
+        std::vector<W> weights(counts.back());
+        parallel_chunks(pool, block_targets.size(), 1, [&](std::size_t block, std::size_t) {
+            const auto at = counts[first[block]];
+            std::copy(block_targets[block].begin(), block_targets[block].end(), targets.begin() + at);
+            std::copy(block_weights[block].begin(), block_weights[block].end(), weights.begin() + at);
+            std::vector<std::uint32_t>().swap(block_targets[block]);
+            std::vector<W>().swap(block_weights[block]);
+        });
+        return CsrGraph<V, W>(identity_labels<V>(n, pool), std::move(counts), std::move(targets), std::move(weights));
+    }
+}
+
+// directed G(n, p) without self loops. every row walks its n - 1 candidate targets with geometric
+// skips (batagelj-brandes), so the cost is linear in the number of generated edges
+template <std::integral V = int, Weight W = int>
+CsrGraph<V, W> erdos_renyi_graph(std::size_t n, double p, ThreadPool* pool = nullptr, const GeneratorOptions& options = {}) {
+    using namespace generators_detail;
+    check_vertex_count(n);
+    check_weights(options);
+    if (!(p >= 0.0 && p <= 1.0)) {
+        throw std::invalid_argument("Edge probability has to be in [0, 1]");
+    }
+
+    // aim for about BLOCK edges per block
+    const auto expected_degree = p * static_cast<double>(n > 0 ? n - 1 : 0);
+    const auto rows_per_block = std::max<std::size_t>(1, static_cast<std::size_t>(BLOCK / std::max(1.0, expected_degree)));
+    const auto blocks = (n + rows_per_block - 1) / rows_per_block;
+
+    std::vector<std::size_t> first(blocks + 1);
+    for (std::size_t block = 0; block <= blocks; ++block) {
+        first[block] = std::min(n, block * rows_per_block);
+    }
+    std::vector<std::size_t> counts(n + 1, 0);
+    std::vector<std::vector<std::uint32_t>> block_targets(blocks);
+    std::vector<std::vector<W>> block_weights(blocks);
+
+    const auto log_q = std::log1p(-p);
+    parallel_chunks(pool, blocks, 1, [&](std::size_t block, std::size_t) {
+        auto gen = stream(options.seed, block);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::uniform_int_distribution<int> weight_dist(options.min_weight, options.max_weight);
+        auto& targets = block_targets[block];
+        auto& weights = block_weights[block];
+        targets.reserve(static_cast<std::size_t>(expected_degree * (first[block + 1] - first[block]) * 1.1));
+        weights.reserve(targets.capacity());
+
+        for (auto u = first[block]; u < first[block + 1]; ++u) {
+            const auto begin = targets.size();
+            // candidate j maps to target j, skipping u itself
+            for (double j = -1.0; p > 0.0;) {
+                j += p == 1.0 ? 1.0 : 1.0 + std::floor(std::log1p(-uniform(gen)) / log_q);
+                if (j >= static_cast<double>(n - 1)) {
+                    break;
+                }
+                const auto candidate = static_cast<std::size_t>(j);
+                targets.push_back(static_cast<std::uint32_t>(candidate < u ? candidate : candidate + 1));
+                weights.push_back(static_cast<W>(weight_dist(gen)));
+            }
+            counts[u + 1] = targets.size() - begin;
+        }
+    });
+
+    return assemble<V, W>(first, std::move(counts), block_targets, block_weights, pool);
+}
+
+// recursive matrix (kronecker) graph with 2^scale vertices and edge_factor * 2^scale sampled edges.
+// vertex ids are scrambled by a bijection so hubs are not packed at low ids, self loops are dropped
+// and parallel edges keep the lightest weight, so the edge count ends up slightly below the target
+template <std::integral V = int, Weight W = int>
+CsrGraph<V, W> rmat_graph(
+    unsigned scale,
+    std::size_t edge_factor,
+    ThreadPool* pool = nullptr,
+    const GeneratorOptions& options = {},
+    const RmatParameters& parameters = {}
+) {
+    using namespace generators_detail;
+    if (scale >= 32) {
+        throw std::invalid_argument("Too many vertices for 32-bit ids");
+    }
+    check_weights(options);
+    const auto d = 1.0 - parameters.a - parameters.b - parameters.c;
+    if (parameters.a < 0.0 || parameters.b < 0.0 || parameters.c < 0.0 || d < 0.0) {
+        throw std::invalid_argument("R-MAT probabilities have to be non-negative and sum to at most 1");
+    }
+
+    const auto n = std::size_t{1} << scale;
+    const auto m = edge_factor << scale;
+    const auto mask = static_cast<std::uint32_t>(n - 1);
+    const auto multiplier = static_cast<std::uint32_t>(mix(options.seed) | 1);
+    auto scramble = [&](std::uint32_t x) {
+        x ^= x >> (scale / 2 + 1);
+        return (x * multiplier) & mask;
+    };
+
+    std::vector<std::uint32_t> sources(m), targets(m);
+    std::vector<W> weights(m);
+    const auto edge_blocks = (m + BLOCK - 1) / BLOCK;
+    parallel_chunks(pool, edge_blocks, 1, [&](std::size_t block, std::size_t) {
+        auto gen = stream(options.seed, block);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::uniform_int_distribution<int> weight_dist(options.min_weight, options.max_weight);
+        const auto end = std::min(m, (block + 1) * BLOCK);
+        for (auto e = block * BLOCK; e < end; ++e) {
+            std::uint32_t u = 0, v = 0;
+            for (unsigned level = 0; level < scale; ++level) {
+                const auto r = uniform(gen);
+                const std::uint32_t right = r >= parameters.a && (r < parameters.a + parameters.b || r >= parameters.a + parameters.b + parameters.c);
+                const std::uint32_t down = r >= parameters.a + parameters.b;
+                u = (u << 1) | down;
+                v = (v << 1) | right;
+            }
+            sources[e] = scramble(u);
+            targets[e] = scramble(v);
+            weights[e] = static_cast<W>(weight_dist(gen));
+        }
+    });
+
+    // bucket by source, the order inside a row is fixed afterwards by sorting on (target, weight)
+    std::vector<std::size_t> offsets(n + 1, 0);
+    parallel_chunks(pool, edge_blocks, 1, [&](std::size_t block, std::size_t) {
+        const auto end = std::min(m, (block + 1) * BLOCK);
+        for (auto e = block * BLOCK; e < end; ++e) {
+            std::atomic_ref<std::size_t>(offsets[sources[e] + 1]).fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<std::pair<std::uint32_t, W>> rows(m);
+    {
+        auto cursor = offsets;
+        parallel_chunks(pool, edge_blocks, 1, [&](std::size_t block, std::size_t) {
+            const auto end = std::min(m, (block + 1) * BLOCK);
+            for (auto e = block * BLOCK; e < end; ++e) {
+                const auto at = std::atomic_ref<std::size_t>(cursor[sources[e]]).fetch_add(1, std::memory_order_relaxed);
+                rows[at] = {targets[e], weights[e]};
+            }
+        });
+    }
+    std::vector<std::uint32_t>().swap(sources);
+
+    const auto row_blocks = (n + BLOCK - 1) / BLOCK;
+    std::vector<std::size_t> counts(n + 1, 0);
+    parallel_chunks(pool, row_blocks, 1, [&](std::size_t block, std::size_t) {
+        const auto end = std::min(n, (block + 1) * BLOCK);
+        for (auto u = block * BLOCK; u < end; ++u) {
+            const auto begin = rows.begin() + offsets[u];
+            auto last = rows.begin() + offsets[u + 1];
+            std::sort(begin, last);
+            last = std::unique(begin, last, [](const auto& x, const auto& y) {
+                return x.first == y.first;
+            });
+            last = std::remove_if(begin, last, [u](const auto& entry) {
+                return entry.first == u;
+            });
+            counts[u + 1] = static_cast<std::size_t>(last - begin);
+        }
+    });
+
+    std::partial_sum(counts.begin(), counts.end(), counts.begin());
+    targets.resize(counts.back());
+    weights.resize(counts.back());
+    targets.shrink_to_fit();
+    weights.shrink_to_fit();
+    parallel_chunks(pool, row_blocks, 1, [&](std::size_t block, std::size_t) {
+        const auto end = std::min(n, (block + 1) * BLOCK);
+        for (auto u = block * BLOCK; u < end; ++u) {
+            for (std::size_t i = 0; i < counts[u + 1] - counts[u]; ++i) {
+                targets[counts[u] + i] = rows[offsets[u] + i].first;
+                weights[counts[u] + i] = rows[offsets[u] + i].second;
+            }
+        }
+    });
+
+    return CsrGraph<V, W>(identity_labels<V>(n, pool), std::move(counts), std::move(targets), std::move(weights));
+}
+
+// road-like grid: vertex r * cols + c links to its 4 neighbours in both directions with the same
+// weight, every street is kept with probability `keep`. weights and drops are hashed from the
+// street id instead of drawn from a stream, so both directions agree without coordination
+template <std::integral V = int, Weight W = int>
+CsrGraph<V, W> grid_graph(
+    std::size_t rows,
+    std::size_t cols,
+    double keep = 1.0,
+    ThreadPool* pool = nullptr,
+    const GeneratorOptions& options = {}
+) {
+    using namespace generators_detail;
+    const auto n = rows * cols;
+    check_vertex_count(n);
+    check_weights(options);
+    if (!(keep >= 0.0 && keep <= 1.0)) {
+        throw std::invalid_argument("Keep probability has to be in [0, 1]");
+    }
+
+    const auto span = static_cast<std::uint64_t>(options.max_weight) - options.min_weight + 1;
+    const auto threshold = static_cast<double>(std::numeric_limits<std::uint64_t>::max()) * keep;
+    // street 2 * u leads right of u, street 2 * u + 1 leads down
+    auto street = [&](std::uint64_t id) {
+        return mix(options.seed ^ mix(id));
+    };
+    auto kept = [&](std::uint64_t id) {
+        return keep == 1.0 || static_cast<double>(street(id)) < threshold;
+    };
+    auto weight = [&](std::uint64_t id) {
+        return static_cast<W>(options.min_weight + static_cast<long long>(mix(street(id)) % span));
+    };
+
+    // neighbours in increasing id order: up, left, right, down
+    auto for_each_neighbor = [&](std::size_t u, auto&& fn) {
+        const auto r = u / cols, c = u % cols;
+        if (r > 0 && kept(2 * (u - cols) + 1)) {
+            fn(u - cols, 2 * (u - cols) + 1);
+        }
+        if (c > 0 && kept(2 * (u - 1))) {
+            fn(u - 1, 2 * (u - 1));
+        }
+        if (c + 1 < cols && kept(2 * u)) {
+            fn(u + 1, 2 * u);
+        }
+        if (r + 1 < rows && kept(2 * u + 1)) {
+            fn(u + cols, 2 * u + 1);
+        }
+    };
+
+    const auto blocks = (n + BLOCK - 1) / BLOCK;
+    std::vector<std::size_t> offsets(n + 1, 0);
+    parallel_chunks(pool, blocks, 1, [&](std::size_t block, std::size_t) {
+        const auto end = std::min(n, (block + 1) * BLOCK);
+        for (auto u = block * BLOCK; u < end; ++u) {
+            for_each_neighbor(u, [&](std::size_t, std::uint64_t) {
+                offsets[u + 1]++;
+            });
+        }
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<std::uint32_t> targets(offsets.back());
+    std::vector<W> weights(offsets.back());
+    parallel_chunks(pool, blocks, 1, [&](std::size_t block, std::size_t) {
+        const auto end = std::min(n, (block + 1) * BLOCK);
+        for (auto u = block * BLOCK; u < end; ++u) {
+            auto at = offsets[u];
+            for_each_neighbor(u, [&](std::size_t v, std::uint64_t id) {
+                targets[at] = static_cast<std::uint32_t>(v);
+                weights[at++] = weight(id);
+            });
+        }
+    });
+
+    return CsrGraph<V, W>(identity_labels<V>(n, pool), std::move(offsets), std::move(targets), std::move(weights));
+}
@@ -3,7 +3,10 @@
 #include <algorithm>
 #include <compare>
 #include <concepts>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <numeric>
 #include <optional>
 #include <queue>
 #include <stdexcept>
@@ -65,9 +68,542 @@ struct Edge {
     }
 };
 
+// reusable dijkstra workspace, vertices are interned into dense ids on first touch and the
+// per-vertex state is invalidated by bumping a generation counter instead of being cleared
+template <Vertex V, Weight W>
+class SearchContext {
+public:
+    using Node = std::pair<W, std::size_t>;
+
+    std::size_t intern(const V& vtx) {
+        const auto [it, inserted] = ids.try_emplace(vtx, labels.size());
+        if (inserted) {
+            labels.push_back(vtx);
+            distances.push_back(W{});
+            pred_ids.push_back(it->second);
+            pred_edges.push_back({vtx, vtx, W{}});
+            stamps.push_back(0);
+        }
+        return it->second;
+    }
+
+    // O(1) reset, storage and heap capacity are kept for the next query
+    void reset() {
+        if (++generation == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+        heap.clear();
+    }
+
+    bool reached(std::size_t id) const {
+        return stamps[id] == generation;
+    }
+
+    const W& distance(std::size_t id) const {
+        return distances[id];
+    }
+
+    const Edge<V, W>& pred_edge(std::size_t id) const {
+        return pred_edges[id];
+    }
+
+    std::size_t pred(std::size_t id) const {
+        return pred_ids[id];
+    }
+
+    const V& label(std::size_t id) const {
+        return labels[id];
+    }
+
+    void set_source(std::size_t id) {
+        stamps[id] = generation;
+        distances[id] = W{0};
+        pred_ids[id] = id;
+    }
+
+    void set(std::size_t id, const W& distance, std::size_t pred, const Edge<V, W>& edge) {
+        stamps[id] = generation;
+        distances[id] = distance;
+        pred_ids[id] = pred;
+        pred_edges[id] = edge;
+    }
+
+    void push(const W& distance, std::size_t id) {
+        heap.push_back({distance, id});
+        std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+    }
+
+    Node pop() {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+        const auto node = heap.back();
+        heap.pop_back();
+        return node;
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    std::size_t size() const {
+        return labels.size();
+    }
+
+    // walks predecessor edges back from `id` to the source of the last search
+    std::vector<Edge<V, W>> path_to(std::size_t id) const {
+        std::vector<Edge<V, W>> path;
+        while (pred_ids[id] != id) {
+            path.push_back(pred_edges[id]);
+            id = pred_ids[id];
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+private:
+    std::unordered_map<V, std::size_t> ids;
+    std::vector<V> labels;
+    std::vector<W> distances;
+    std::vector<std::size_t> pred_ids;
+    std::vector<Edge<V, W>> pred_edges;
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t generation = 1;
+    std::vector<Node> heap;
+};
+
+// distances and incoming tree edges of every vertex reachable from the source
+template <Vertex V, Weight W>
+struct ShortestPathTree {
+    std::unordered_map<V, W> distances;
+    std::unordered_map<V, Edge<V, W>> parents;
+};
+
+// one change of a batch: a weight inserts the edge or overwrites the weight of an existing one,
+// nullopt removes it
+template <Vertex V, Weight W>
+struct EdgeUpdate {
+    V from;
+    V to;
+    std::optional<W> weight;
+};
+
+// compile time counterpart of Graph for the free algorithms below: vertices are addressed by an
+// id_type chosen by the representation and neighbors are handed to a callback as (id, weight),
+// so no edge vector is built and the relaxation loop is inlined for every layout
+template <typename G>
+concept GraphView = requires (
+    const G& graph,
+    const typename G::vertex_type& vtx,
+    const typename G::id_type& id
+) {
+    requires Vertex<typename G::vertex_type>;
+    requires Weight<typename G::weight_type>;
+    requires std::totally_ordered<typename G::id_type>;
+    { graph.vertex_count() } -> std::convertible_to<std::size_t>;
+    { graph.index_of(vtx) } -> std::convertible_to<std::optional<typename G::id_type>>;
+    { graph.label(id) } -> std::convertible_to<typename G::vertex_type>;
+    graph.for_each_vertex([](const typename G::id_type&) {});
+    graph.for_each_neighbor(id, [](const typename G::id_type&, const typename G::weight_type&) {});
+};
+
+// views whose ids are integers below id_bound(), per vertex state then lives in flat arrays
+// instead of a hash map keyed by id
+template <typename G>
+concept DenseGraphView = GraphView<G>
+    && std::unsigned_integral<typename G::id_type>
+    && requires (const G& graph) {
+        { graph.id_bound() } -> std::convertible_to<std::size_t>;
+    };
+
+namespace view_detail {
+    template <GraphView G>
+    struct Label {
+        typename G::weight_type distance;
+        typename G::id_type pred;
+        typename G::weight_type pred_weight;
+        bool reached;
+    };
+
+    // per vertex state, untouched ids read as `initial`
+    template <GraphView G, typename T>
+    class IdMap {
+        using Id = typename G::id_type;
+
+        T initial;
+        std::conditional_t<DenseGraphView<G>, std::vector<T>, std::unordered_map<Id, T>> values;
+
+    public:
+        IdMap(const G& graph, const T& initial)
+            : initial(initial)
+        {
+            if constexpr (DenseGraphView<G>) {
+                values.assign(graph.id_bound(), initial);
+            } else {
+                values.reserve(graph.vertex_count());
+            }
+        }
+
+        T& operator[](const Id& id) {
+            if constexpr (DenseGraphView<G>) {
+                return values[id];
+            } else {
+                return values.try_emplace(id, initial).first->second;
+            }
+        }
+    };
+
+    template <GraphView G>
+    using LabelMap = IdMap<G, Label<G>>;
+
+    // follows pred links from `end` back to `start`, nullopt when they loop (possible when a
+    // negative cycle was not checked for)
+    template <GraphView G>
+    std::optional<std::vector<Edge<typename G::vertex_type, typename G::weight_type>>> path_to(
+        const G& graph,
+        LabelMap<G>& labels,
+        const typename G::id_type& start,
+        const typename G::id_type& end
+    ) {
+        std::vector<Edge<typename G::vertex_type, typename G::weight_type>> path;
+        for (auto id = end; id != start;) {
+            if (path.size() >= graph.vertex_count()) {
+                return std::nullopt;
+            }
+            const auto& label = labels[id];
+            path.push_back({graph.label(label.pred), graph.label(id), label.pred_weight});
+            id = label.pred;
+        }
+        std::reverse(path.begin(), path.end());
+        return std::make_optional(path);
+    }
+
+    // flat copy of a vertex and edge list, lets the virtual interface run the dense algorithms
+    template <Vertex V, Weight W>
+    class EdgeSnapshot {
+        std::unordered_map<V, std::size_t> ids;
+        std::vector<V> labels;
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> targets;
+        std::vector<W> weights;
+
+    public:
+        using vertex_type = V;
+        using weight_type = W;
+        using id_type = std::size_t;
+
+        EdgeSnapshot(const std::vector<V>& vertices, const std::vector<Edge<V, W>>& edges)
+            : labels(vertices), offsets(vertices.size() + 1, 0)
+        {
+            ids.reserve(vertices.size());
+            for (std::size_t i = 0; i < vertices.size(); ++i) {
+                ids.emplace(vertices[i], i);
+            }
+            for (const auto& edge : edges) {
+                offsets[ids.at(edge.from) + 1]++;
+            }
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+            targets.resize(edges.size());
+            weights.resize(edges.size());
+            auto fill = offsets;
+            for (const auto& edge : edges) {
+                const auto pos = fill[ids.at(edge.from)]++;
+                targets[pos] = ids.at(edge.to);
+                weights[pos] = edge.weight;
+            }
+        }
+
+        std::size_t vertex_count() const {
+            return labels.size();
+        }
+
+        std::size_t id_bound() const {
+            return labels.size();
+        }
+
+        std::optional<std::size_t> index_of(const V& vtx) const {
+            const auto it = ids.find(vtx);
+            if (it == ids.end()) {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+
+        const V& label(std::size_t id) const {
+            return labels[id];
+        }
+
+        template <typename F>
+        void for_each_vertex(F&& fn) const {
+            for (std::size_t id = 0; id < labels.size(); ++id) {
+                fn(id);
+            }
+        }
+
+        template <typename F>
+        void for_each_neighbor(std::size_t id, F&& fn) const {
+            for (auto i = offsets[id]; i < offsets[id + 1]; ++i) {
+                fn(targets[i], weights[i]);
+            }
+        }
+    };
+
+    // kahn's algorithm one frontier at a time, every frontier only holds vertices whose predecessors
+    // all sit in earlier ones, so the vertices of a frontier are independent of each other. with
+    // `root` only the part reachable from it is ordered. nullopt when the ordered part has a cycle
+    template <GraphView G>
+    std::optional<std::vector<typename G::id_type>> topological_ids(
+        const G& graph,
+        const std::optional<typename G::id_type>& root = std::nullopt
+    ) {
+        using Id = typename G::id_type;
+        struct Count {
+            std::size_t in_degree;
+            bool seen;
+        };
+
+        IdMap<G, Count> counts(graph, {0, false});
+        std::vector<Id> order;
+        std::size_t members = 0;
+        if (root) {
+            // in-degrees from the reachable part only, edges from outside cannot close a cycle in it
+            counts[*root].seen = true;
+            order.push_back(*root);
+            for (std::size_t head = 0; head < order.size(); ++head) {
+                graph.for_each_neighbor(order[head], [&](const Id& to, const auto&) {
+                    auto& count = counts[to];
+                    ++count.in_degree;
+                    if (!count.seen) {
+                        count.seen = true;
+                        order.push_back(to);
+                    }
+                });
+            }
+            members = order.size();
+            order.clear();
+            if (counts[*root].in_degree != 0) {
+                return std::nullopt;
+            }
+            order.push_back(*root);
+        } else {
+            graph.for_each_vertex([&](const Id& from) {
+                ++members;
+                graph.for_each_neighbor(from, [&](const Id& to, const auto&) {
+                    ++counts[to].in_degree;
+                });
+            });
+            graph.for_each_vertex([&](const Id& id) {
+                if (counts[id].in_degree == 0) {
+                    order.push_back(id);
+                }
+            });
+        }
+        order.reserve(members);
+
+        for (std::size_t begin = 0, end = order.size(); begin < end; begin = end, end = order.size()) {
+            for (auto i = begin; i < end; ++i) {
+                graph.for_each_neighbor(order[i], [&](const Id& to, const auto&) {
+                    if (--counts[to].in_degree == 0) {
+                        order.push_back(to);
+                    }
+                });
+            }
+        }
+        if (order.size() != members) {
+            return std::nullopt;
+        }
+        return std::make_optional(order);
+    }
+
+    // one relaxation pass in topological order settles every vertex, negative weights included
+    template <GraphView G>
+    std::optional<std::vector<Edge<typename G::vertex_type, typename G::weight_type>>> dag_path(
+        const G& graph,
+        const std::vector<typename G::id_type>& order,
+        const typename G::id_type& start,
+        const typename G::id_type& end
+    ) {
+        using W = typename G::weight_type;
+        using Id = typename G::id_type;
+
+        LabelMap<G> labels(graph, {W{}, start, W{}, false});
+        labels[start] = {W{0}, start, W{}, true};
+        for (const auto& from : order) {
+            const auto source = labels[from];
+            if (!source.reached) {
+                continue;
+            }
+            if (from == end) {
+                break;
+            }
+            graph.for_each_neighbor(from, [&](const Id& to, const W& weight) {
+                const auto new_distance = source.distance + weight;
+                auto& label = labels[to];
+                if (!label.reached || new_distance < label.distance) {
+                    label = {new_distance, from, weight, true};
+                }
+            });
+        }
+        if (!labels[end].reached) {
+            return std::nullopt;
+        }
+        return path_to(graph, labels, start, end);
+    }
+}
+
+// point to point dijkstra on any view, weights must be non-negative. nullopt when an endpoint is
+// missing or `end` is unreachable
+template <GraphView G>
+std::optional<std::vector<Edge<typename G::vertex_type, typename G::weight_type>>> dijkstra(
+    const G& graph,
+    const typename G::vertex_type& start,
+    const typename G::vertex_type& end
+) {
+    using W = typename G::weight_type;
+    using Id = typename G::id_type;
+
+    const auto start_id = graph.index_of(start);
+    const auto end_id = graph.index_of(end);
+    if (!start_id || !end_id) {
+        return std::nullopt;
+    }
+
+    view_detail::LabelMap<G> labels(graph, {W{}, *start_id, W{}, false});
+    labels[*start_id] = {W{0}, *start_id, W{}, true};
+    std::vector<std::pair<W, Id>> heap{{W{0}, *start_id}};
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+        const auto [distance, id] = heap.back();
+        heap.pop_back();
+
+        // skip stale heap entries
+        if (distance > labels[id].distance) {
+            continue;
+        }
+        if (id == *end_id) {
+            return view_detail::path_to(graph, labels, *start_id, id);
+        }
+
+        graph.for_each_neighbor(id, [&](const Id& to, const W& weight) {
+            const auto new_distance = distance + weight;
+            auto& label = labels[to];
+            if (!label.reached || new_distance < label.distance) {
+                label = {new_distance, id, weight, true};
+                heap.push_back({new_distance, to});
+                std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+            }
+        });
+    }
+    return std::nullopt;
+}
+
+// vertices in topological order, nullopt when the graph has a cycle
+template <GraphView G>
+std::optional<std::vector<typename G::vertex_type>> topological_order(const G& graph) {
+    const auto ids = view_detail::topological_ids(graph);
+    if (!ids) {
+        return std::nullopt;
+    }
+    std::vector<typename G::vertex_type> order;
+    order.reserve(ids->size());
+    for (const auto& id : *ids) {
+        order.push_back(graph.label(id));
+    }
+    return std::make_optional(order);
+}
+
+// shortest path in O(V + E) when the part reachable from `start` is acyclic, negative weights are
+// fine. nullopt when an endpoint is missing or `end` is unreachable, throws if a cycle is reachable
+template <GraphView G>
+std::optional<std::vector<Edge<typename G::vertex_type, typename G::weight_type>>> dag_shortest_paths(
+    const G& graph,
+    const typename G::vertex_type& start,
+    const typename G::vertex_type& end
+) {
+    const auto start_id = graph.index_of(start);
+    const auto end_id = graph.index_of(end);
+    if (!start_id || !end_id) {
+        return std::nullopt;
+    }
+    const auto order = view_detail::topological_ids(graph, start_id);
+    if (!order) {
+        throw std::invalid_argument("dag_shortest_paths requires an acyclic graph");
+    }
+    return view_detail::dag_path(graph, *order, *start_id, *end_id);
+}
+
+// round based bellman-ford from `start` that stops once a round changes nothing, with
+// cycle_check a negative cycle reachable from `start` makes the result nullopt. with detect_dag
+// the reachable part is first ordered topologically, which costs about one round, and when it is
+// acyclic a single pass in that order replaces the rounds
+template <GraphView G>
+std::optional<std::vector<Edge<typename G::vertex_type, typename G::weight_type>>> bellman_ford(
+    const G& graph,
+    const typename G::vertex_type& start,
+    const typename G::vertex_type& end,
+    bool cycle_check = true,
+    bool detect_dag = true
+) {
+    using W = typename G::weight_type;
+    using Id = typename G::id_type;
+
+    const auto start_id = graph.index_of(start);
+    const auto end_id = graph.index_of(end);
+    if (!start_id || !end_id) {
+        return std::nullopt;
+    }
+    if (detect_dag) {
+        if (const auto order = view_detail::topological_ids(graph, start_id)) {
+            return view_detail::dag_path(graph, *order, *start_id, *end_id);
+        }
+    }
+
+    view_detail::LabelMap<G> labels(graph, {W{}, *start_id, W{}, false});
+    labels[*start_id] = {W{0}, *start_id, W{}, true};
+
+    auto relax_round = [&] {
+        bool updated = false;
+        graph.for_each_vertex([&](const Id& from) {
+            const auto source = labels[from];
+            if (!source.reached) {
+                return;
+            }
+            graph.for_each_neighbor(from, [&](const Id& to, const W& weight) {
+                const auto new_distance = source.distance + weight;
+                auto& label = labels[to];
+                if (!label.reached || new_distance < label.distance) {
+                    label = {new_distance, from, weight, true};
+                    updated = true;
+                }
+            });
+        });
+        return updated;
+    };
+
+    for (std::size_t round = 1; round < graph.vertex_count(); ++round) {
+        if (!relax_round()) {
+            break;
+        }
+    }
+    if (cycle_check && relax_round()) {
+        return std::nullopt;
+    }
+
+    if (!labels[*end_id].reached) {
+        return std::nullopt;
+    }
+    return view_detail::path_to(graph, labels, *start_id, *end_id);
+}
+
+template <Vertex V, Weight W>
+class GraphAdapter;
+
 template <Vertex V, Weight W>
 class Graph {
 public:
+    using vertex_type = V;
+    using weight_type = W;
+
     virtual ~Graph() = default;
 
     virtual bool add_vertex(const V& vtx) = 0;
@@ -86,128 +622,327 @@ public:
     virtual std::vector<Edge<V, W>> get_edges() const = 0;
     virtual std::optional<std::vector<Edge<V, W>>> get_edges(const V& vtx) const = 0;
 
+    // edges ending at `vtx`, this default scans every edge, representations with an in-edge index override it
+    virtual std::optional<std::vector<Edge<V, W>>> get_in_edges(const V& vtx) const {
+        if (!has_vertex(vtx)) {
+            return std::nullopt;
+        }
+        std::vector<Edge<V, W>> result;
+        for (const auto& edge : get_edges()) {
+            if (edge.to == vtx) {
+                result.push_back(edge);
+            }
+        }
+        return std::make_optional(result);
+    }
+
+    // applies the updates in order, endpoints of inserted edges are added when missing. this
+    // default goes through remove_edge/add_edge one update at a time, representations that can
+    // group the work per source override it
+    virtual void apply_batch(const std::vector<EdgeUpdate<V, W>>& updates) {
+        for (const auto& update : updates) {
+            remove_edge(update.from, update.to);
+            if (!update.weight) {
+                continue;
+            }
+            const Edge<V, W> edge{update.from, update.to, *update.weight};
+            if (!add_edge(edge)) {
+                add_vertex(update.from);
+                add_vertex(update.to);
+                add_edge(edge);
+            }
+        }
+    }
+
     // path methods
+    // the path methods without a workspace run the free templates through GraphAdapter, callers
+    // holding a concrete representation can call those directly and skip the virtual dispatch
     std::optional<std::vector<Edge<V, W>>> dijkstra(const V& start, const V& end) const {
-        using Node = std::pair<W, V>;
+        // like the context version, start == end is an empty path even for an unknown vertex
+        if (start == end) {
+            return std::make_optional(std::vector<Edge<V, W>>{});
+        }
+        return ::dijkstra(GraphAdapter<V, W>(*this), start, end);
+    }
+
+    // same as above but reuses the caller's workspace, so repeated queries allocate nothing once it is warm
+    std::optional<std::vector<Edge<V, W>>> dijkstra(const V& start, const V& end, SearchContext<V, W>& context) const {
+        std::optional<std::size_t> end_id;
+        dijkstra_visit(start, context, [&](std::size_t id) {
+            if (context.label(id) == end) {
+                end_id = id;
+                return true;
+            }
+            return false;
+        });
+        if (!end_id) {
+            return std::nullopt;
+        }
+        return std::make_optional(context.path_to(*end_id));
+    }
 
-        std::unordered_map<V, std::optional<W>> distances;
-        std::unordered_map<V, V> prev;
-        std::priority_queue<Node, std::vector<Node>, std::greater<>> pq;
+    ShortestPathTree<V, W> shortest_path_tree(const V& source) const {
+        SearchContext<V, W> context;
+        return shortest_path_tree(source, context);
+    }
 
-        const auto vertices = get_vertices();
+    ShortestPathTree<V, W> shortest_path_tree(const V& source, SearchContext<V, W>& context) const {
+        ShortestPathTree<V, W> tree;
+        dijkstra_visit(source, context, [&](std::size_t id) {
+            tree.distances.emplace(context.label(id), context.distance(id));
+            if (context.pred(id) != id) {
+                tree.parents.emplace(context.label(id), context.pred_edge(id));
+            }
+            return false;
+        });
+        return tree;
+    }
 
-        // initialize distances
-        for (const auto& vtx : vertices) {
-            distances[vtx] = std::nullopt;
-        }
-        distances[start] = std::make_optional(W{0});
-        pq.push({W{0}, start});
+    // runs dijkstra from `start` and calls on_settle(id) for every vertex once its distance is final,
+    // the search stops early when on_settle returns true, results stay readable in `context`
+    template <typename F>
+    void dijkstra_visit(const V& start, SearchContext<V, W>& context, F&& on_settle) const {
+        context.reset();
+
+        const auto start_id = context.intern(start);
+        context.set_source(start_id);
+        context.push(W{0}, start_id);
 
-        while (!pq.empty()) {
-            auto [current_distance_val, current_vertex] = pq.top();
-            pq.pop();
+        while (!context.empty()) {
+            const auto [current_distance, current_id] = context.pop();
 
-            // skip if we've found a better path or current_vertex is unreachable initially (should not happen with proper start)
-            if (!distances[current_vertex].has_value() || current_distance_val > *distances[current_vertex]) {
+            // skip stale heap entries
+            if (current_distance > context.distance(current_id)) {
                 continue;
             }
 
-            if (current_vertex == end) {
-                std::vector<Edge<V, W>> path;
-                while (current_vertex != start) {
-                    const auto edge_opt = get_edge(prev[current_vertex], current_vertex);
-                    if (!edge_opt) {
-                        return std::nullopt;
-                    }
-                    path.push_back(edge_opt.value());
-                    current_vertex = prev[current_vertex];
-                }
-                std::reverse(path.begin(), path.end());
-                return std::make_optional(path);
+            if (on_settle(current_id)) {
+                return;
             }
 
-            const auto edges_opt = get_edges(current_vertex);
-            if (!edges_opt) { // check if get_edges returned a valid optional
+            const auto edges_opt = get_edges(context.label(current_id));
+            if (!edges_opt) {
                 continue;
             }
 
             for (const auto& edge : *edges_opt) {
-                // new_distance calculation assumes current_distance_val is finite (from PQ)
-                const auto new_distance = current_distance_val + edge.weight;
-                if (!distances[edge.to].has_value() || new_distance < *distances[edge.to]) {
-                    distances[edge.to] = std::make_optional(new_distance);
-                    prev[edge.to] = current_vertex;
-                    pq.push({new_distance, edge.to});
+                const auto new_distance = current_distance + edge.weight;
+                const auto to_id = context.intern(edge.to);
+                if (!context.reached(to_id) || new_distance < context.distance(to_id)) {
+                    context.set(to_id, new_distance, current_id, edge);
+                    context.push(new_distance, to_id);
                 }
             }
         }
-        return std::nullopt;
     }
 
-    std::optional<std::vector<Edge<V, W>>> bellman_ford(const V& start, const V& end, bool cycle_check = true) const {
-        std::unordered_map<V, std::optional<W>> distances;
-        std::unordered_map<V, V> prev;
+    // every round walks all edges, so the graph is flattened once up front
+    std::optional<std::vector<Edge<V, W>>> bellman_ford(const V& start, const V& end, bool cycle_check = true, bool detect_dag = true) const {
+        return ::bellman_ford(view_detail::EdgeSnapshot<V, W>(get_vertices(), get_edges()), start, end, cycle_check, detect_dag);
+    }
+
+    std::optional<std::vector<V>> topological_order() const {
+        return ::topological_order(view_detail::EdgeSnapshot<V, W>(get_vertices(), get_edges()));
+    }
 
+    std::optional<std::vector<Edge<V, W>>> dag_shortest_paths(const V& start, const V& end) const {
+        return ::dag_shortest_paths(view_detail::EdgeSnapshot<V, W>(get_vertices(), get_edges()), start, end);
+    }
+
+    // returns the edges of a negative cycle in order, or nullopt when there is none
+    std::optional<std::vector<Edge<V, W>>> find_negative_cycle() const {
+        std::vector<W> distances;
+        return subtree_disassembly(get_vertices(), get_edges(), distances);
+    }
+
+    // feasible vertex potentials (distances from a virtual source with zero edges to every vertex),
+    // w(u, v) + p(u) - p(v) >= 0 holds for every edge, nullopt when a negative cycle exists
+    std::optional<std::unordered_map<V, W>> potentials() const {
         const auto vertices = get_vertices();
-        const auto edges = get_edges(); // Get all edges once!
+        std::vector<W> distances;
+        if (subtree_disassembly(vertices, get_edges(), distances)) {
+            return std::nullopt;
+        }
+        std::unordered_map<V, W> result;
+        result.reserve(vertices.size());
+        for (std::size_t i = 0; i < vertices.size(); ++i) {
+            result.emplace(vertices[i], distances[i]);
+        }
+        return result;
+    }
 
-        for (const auto& vtx : vertices) {
-            distances[vtx] = std::nullopt;
+protected:
+    // queue based bellman-ford with tarjan's subtree disassembly, every vertex starts at distance 0
+    // (as if reached from a virtual source), `distances` ends up indexed like `vertices` and is only
+    // final when no cycle is returned
+    std::optional<std::vector<Edge<V, W>>> subtree_disassembly(
+        const std::vector<V>& vertices,
+        const std::vector<Edge<V, W>>& edges,
+        std::vector<W>& distances
+    ) const {
+        const auto n = vertices.size();
+
+        std::unordered_map<V, std::size_t> ids;
+        ids.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            ids[vertices[i]] = i;
         }
-        distances[start] = std::make_optional(W{0});
 
-        for (auto i = 0u; i < vertices.size() - 1; ++i) {
-            bool updated = false;
-            for (const auto& edge : edges) {
-                if (distances[edge.from].has_value()) {
-                    W new_dist_val = *distances[edge.from] + edge.weight;
-                    if (!distances[edge.to].has_value() || new_dist_val < *distances[edge.to]) {
-                        distances[edge.to] = std::make_optional(new_dist_val);
-                        prev[edge.to] = edge.from;
-                        updated = true;
-                    }
-                }
-            }
-            if (!updated) {
-                break;
+        // bucket edge indices by source so each scan touches only outgoing edges
+        std::vector<std::size_t> offsets(n + 1, 0);
+        std::vector<std::size_t> targets(edges.size());
+        for (const auto& edge : edges) {
+            offsets[ids[edge.from] + 1]++;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+        std::vector<std::size_t> order(edges.size());
+        {
+            auto fill = offsets;
+            for (std::size_t e = 0; e < edges.size(); ++e) {
+                const auto from = ids[edges[e].from];
+                order[fill[from]] = e;
+                targets[fill[from]++] = ids[edges[e].to];
             }
         }
 
-        // step 3: check for negative cycles
-        if (cycle_check) {
-            for (const auto& edge : edges) {
-                if (distances[edge.from].has_value()) {
-                    W new_dist_val = *distances[edge.from] + edge.weight;
-                    if (!distances[edge.to].has_value() || new_dist_val < *distances[edge.to]) {
-                        return std::nullopt;
+        // shortest path tree kept as a circular preorder list, `root` is the virtual source
+        constexpr auto none = std::numeric_limits<std::size_t>::max();
+        const auto root = n;
+        distances.assign(n, W{0});
+        std::vector<std::size_t> parent(n, none), parent_edge(n, none);
+        std::vector<std::size_t> next(n + 1), prev(n + 1), depth(n + 1, 1);
+        std::vector<bool> in_tree(n, true);
+        std::vector<bool> in_queue(n, true);
+        std::queue<std::size_t> queue;
+
+        depth[root] = 0;
+        for (std::size_t i = 0; i <= n; ++i) {
+            next[i] = i == n ? 0 : i + 1;
+            prev[i] = i == 0 ? n : i - 1;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            queue.push(i);
+        }
+
+        while (!queue.empty()) {
+            const auto u = queue.front();
+            queue.pop();
+            in_queue[u] = false;
+
+            // disassembled vertices wait until one of their labels improves again
+            if (!in_tree[u]) {
+                continue;
+            }
+
+            for (auto i = offsets[u]; i < offsets[u + 1]; ++i) {
+                const auto v = targets[i];
+                const auto& edge = edges[order[i]];
+                const W new_distance = distances[u] + edge.weight;
+                if (!(new_distance < distances[v])) {
+                    continue;
+                }
+
+                // a negative self-loop is a cycle on its own, the descendant walk below never meets u
+                // for it and would relink v as its own child
+                if (u == v) {
+                    return std::make_optional(std::vector<Edge<V, W>>{edge});
+                }
+
+                // remove every descendant of v from the tree, if u is among them the new edge closes a cycle
+                if (in_tree[v]) {
+                    auto x = next[v];
+                    while (depth[x] > depth[v]) {
+                        if (x == u) {
+                            std::vector<Edge<V, W>> cycle{edge};
+                            for (auto cur = u; cur != v; cur = parent[cur]) {
+                                cycle.push_back(edges[parent_edge[cur]]);
+                            }
+                            std::reverse(cycle.begin(), cycle.end());
+                            return std::make_optional(cycle);
+                        }
+                        in_tree[x] = false;
+                        x = next[x];
                     }
+
+                    // unlink v together with its (now detached) subtree
+                    next[prev[v]] = x;
+                    prev[x] = prev[v];
                 }
-            }
-        }
 
-        if (!distances[end].has_value()) {
-            return std::nullopt;
-        }
+                distances[v] = new_distance;
+                parent[v] = u;
+                parent_edge[v] = order[i];
+                in_tree[v] = true;
+                depth[v] = depth[u] + 1;
 
-        // reconstruct path
-        std::vector<Edge<V, W>> path;
-        V current = end;
-        while (current != start) {
-            const auto edge_opt = get_edge(prev[current], current);
-            if (!edge_opt) {
-                return std::nullopt;
+                // v becomes the first child of u in preorder
+                next[v] = next[u];
+                prev[v] = u;
+                prev[next[u]] = v;
+                next[u] = v;
+
+                if (!in_queue[v]) {
+                    in_queue[v] = true;
+                    queue.push(v);
+                }
             }
-            path.push_back(edge_opt.value());
-            current = prev[current];
         }
-        std::reverse(path.begin(), path.end());
-        return std::make_optional(path);
+        return std::nullopt;
     }
 
-protected:
     void check_no_loop(const Edge<V, W>& edge) const {
         if (std::equal_to<V>{}(edge.from, edge.to)) {
             throw std::invalid_argument("Self-loops are not allowed.");
         }
     }
 };
+
+// GraphView over the virtual interface for representations that do not model it themselves,
+// every neighbor visit goes through get_edges(vtx) and copies the row
+template <Vertex V, Weight W>
+class GraphAdapter {
+    const Graph<V, W>& graph;
+
+public:
+    using vertex_type = V;
+    using weight_type = W;
+    using id_type = V;
+
+    explicit GraphAdapter(const Graph<V, W>& graph)
+        : graph(graph) {}
+
+    std::size_t vertex_count() const {
+        return graph.vertex_count();
+    }
+
+    std::optional<V> index_of(const V& vtx) const {
+        if (!graph.has_vertex(vtx)) {
+            return std::nullopt;
+        }
+        return vtx;
+    }
+
+    const V& label(const V& vtx) const {
+        return vtx;
+    }
+
+    template <typename F>
+    void for_each_vertex(F&& fn) const {
+        for (const auto& vtx : graph.get_vertices()) {
+            fn(vtx);
+        }
+    }
+
+    template <typename F>
+    void for_each_neighbor(const V& vtx, F&& fn) const {
+        const auto edges = graph.get_edges(vtx);
+        if (!edges) {
+            return;
+        }
+        for (const auto& edge : *edges) {
+            fn(edge.to, edge.weight);
+        }
+    }
+};
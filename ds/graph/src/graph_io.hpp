@@ -0,0 +1,357 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GRAPH_IO_MMAP 1
+#endif
+
+#include "csr.hpp"
+#include "thread_pool.hpp"
+
+// read-only view of a whole file, mmap'ed where available and read into memory otherwise
+class MappedFile {
+    const char* bytes = nullptr;
+    std::size_t length = 0;
+    std::vector<char> buffer;
+
+public:
+    explicit MappedFile(const std::string& path) {
+#if defined(GRAPH_IO_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        if (length > 0) {
+            void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot mmap " + path);
+            }
+            ::madvise(mapped, length, MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(mapped);
+        }
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        length = static_cast<std::size_t>(file.tellg());
+        buffer.resize(length);
+        file.seekg(0);
+        file.read(buffer.data(), static_cast<std::streamsize>(length));
+        bytes = buffer.data();
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(GRAPH_IO_MMAP)
+        if (bytes != nullptr) {
+            ::munmap(const_cast<char*>(bytes), length);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const {
+        return bytes;
+    }
+
+    std::size_t size() const {
+        return length;
+    }
+};
+
+// binary csr file: a fixed header followed by labels, offsets, targets and weights, every section
+// starts on an 8 byte boundary so a mapped file can be used in place
+struct GraphFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t vertex_size;
+    std::uint32_t weight_size;
+    std::uint32_t reserved;
+    std::uint64_t vertex_count;
+    std::uint64_t edge_count;
+};
+
+namespace graph_io_detail {
+    constexpr char MAGIC[8] = {'U', 'N', 'I', 'G', 'R', 'A', 'P', 'H'};
+    constexpr std::uint32_t VERSION = 1;
+
+    constexpr std::size_t padded(std::size_t bytes) {
+        return (bytes + 7) / 8 * 8;
+    }
+
+    // section offsets for a file with n vertices and m edges
+    template <typename V, typename W>
+    struct Layout {
+        std::size_t labels;
+        std::size_t offsets;
+        std::size_t targets;
+        std::size_t weights;
+        std::size_t end;
+
+        Layout(std::uint64_t n, std::uint64_t m) {
+            labels = padded(sizeof(GraphFileHeader));
+            offsets = labels + padded(n * sizeof(V));
+            targets = offsets + (n + 1) * sizeof(std::uint64_t);
+            weights = targets + padded(m * sizeof(std::uint32_t));
+            end = weights + padded(m * sizeof(W));
+        }
+    };
+
+    template <typename T>
+    concept Binary = std::is_trivially_copyable_v<T> && alignof(T) <= 8;
+}
+
+template <Vertex V, Weight W>
+    requires graph_io_detail::Binary<V> && graph_io_detail::Binary<W>
+void write_binary_graph(const std::string& path, const CsrGraph<V, W>& graph) {
+    using namespace graph_io_detail;
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot create " + path);
+    }
+
+    GraphFileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.vertex_size = sizeof(V);
+    header.weight_size = sizeof(W);
+    header.vertex_count = graph.size();
+    header.edge_count = graph.edge_count();
+    const Layout<V, W> layout(header.vertex_count, header.edge_count);
+
+    auto write_at = [&](std::size_t position, const void* data, std::size_t bytes) {
+        static constexpr char zeros[8] = {};
+        const auto current = static_cast<std::size_t>(file.tellp());
+        file.write(zeros, static_cast<std::streamsize>(position - current));
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    };
+
+    std::vector<V> labels(graph.size());
+    for (std::uint32_t id = 0; id < graph.size(); ++id) {
+        labels[id] = graph.label(id);
+    }
+    const std::vector<std::uint64_t> offsets(graph.row_offsets().begin(), graph.row_offsets().end());
+
+    write_at(0, &header, sizeof(header));
+    write_at(layout.labels, labels.data(), labels.size() * sizeof(V));
+    write_at(layout.offsets, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+    write_at(layout.targets, graph.column_targets().data(), graph.edge_count() * sizeof(std::uint32_t));
+    write_at(layout.weights, graph.edge_weights().data(), graph.edge_count() * sizeof(W));
+    write_at(layout.end, nullptr, 0);
+    if (!file) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+// csr arrays served straight from a mapped binary graph file, nothing is parsed or copied. the
+// header, the file size and the row offsets are validated at open, so neighbors() never leaves the
+// mapped sections, edge targets only on check_targets()
+template <Vertex V, Weight W>
+    requires graph_io_detail::Binary<V> && graph_io_detail::Binary<W>
+class MappedGraph {
+    std::unique_ptr<MappedFile> file;
+    std::span<const V> labels;
+    std::span<const std::uint64_t> offsets;
+    std::span<const std::uint32_t> targets;
+    std::span<const W> weights;
+
+public:
+    explicit MappedGraph(const std::string& path)
+        : file(std::make_unique<MappedFile>(path))
+    {
+        using namespace graph_io_detail;
+
+        GraphFileHeader header{};
+        if (file->size() < sizeof(header)) {
+            throw std::runtime_error("Not a graph file: " + path);
+        }
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+            throw std::runtime_error("Not a graph file: " + path);
+        }
+        if (header.vertex_size != sizeof(V) || header.weight_size != sizeof(W)) {
+            throw std::runtime_error("Graph file types do not match: " + path);
+        }
+        if (header.vertex_count > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error("Too many vertices for 32-bit ids: " + path);
+        }
+        // every edge takes a target and a weight, bounding the count by the file size keeps the
+        // section sizes in Layout from wrapping around
+        if (header.edge_count > file->size() / (sizeof(std::uint32_t) + sizeof(W))) {
+            throw std::runtime_error("Truncated graph file: " + path);
+        }
+        const Layout<V, W> layout(header.vertex_count, header.edge_count);
+        if (file->size() < layout.end) {
+            throw std::runtime_error("Truncated graph file: " + path);
+        }
+
+        const auto* base = file->data();
+        labels = {reinterpret_cast<const V*>(base + layout.labels), header.vertex_count};
+        offsets = {reinterpret_cast<const std::uint64_t*>(base + layout.offsets), header.vertex_count + 1};
+        targets = {reinterpret_cast<const std::uint32_t*>(base + layout.targets), header.edge_count};
+        weights = {reinterpret_cast<const W*>(base + layout.weights), header.edge_count};
+
+        // every row has to lie inside the edge sections, O(n) reads of the offsets section only
+        if (offsets.front() != 0 || offsets.back() != header.edge_count
+            || !std::is_sorted(offsets.begin(), offsets.end())) {
+            throw std::runtime_error("Corrupt row offsets in graph file: " + path);
+        }
+    }
+
+    // the targets are not checked at open since that would read every page of the file, a target
+    // of a corrupt file may name a vertex >= size(). throws unless every target is in range
+    void check_targets() const {
+        const auto n = size();
+        if (std::any_of(targets.begin(), targets.end(), [n](std::uint32_t target) { return target >= n; })) {
+            throw std::runtime_error("Edge target out of range in graph file");
+        }
+    }
+
+    std::uint32_t size() const {
+        return static_cast<std::uint32_t>(labels.size());
+    }
+
+    std::size_t edge_count() const {
+        return targets.size();
+    }
+
+    const V& label(std::uint32_t id) const {
+        return labels[id];
+    }
+
+    std::size_t degree(std::uint32_t id) const {
+        return offsets[id + 1] - offsets[id];
+    }
+
+    std::span<const std::uint32_t> neighbors(std::uint32_t id) const {
+        return targets.subspan(offsets[id], degree(id));
+    }
+
+    std::span<const W> neighbor_weights(std::uint32_t id) const {
+        return weights.subspan(offsets[id], degree(id));
+    }
+
+    // owning copy, one bulk copy per section
+    CsrGraph<V, W> to_csr() const {
+        return CsrGraph<V, W>(
+            std::vector<V>(labels.begin(), labels.end()),
+            std::vector<std::size_t>(offsets.begin(), offsets.end()),
+            std::vector<std::uint32_t>(targets.begin(), targets.end()),
+            std::vector<W>(weights.begin(), weights.end())
+        );
+    }
+};
+
+namespace graph_io_detail {
+    template <typename T>
+    bool parse_number(const char*& cursor, const char* end, T& value) {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+            ++cursor;
+        }
+        const auto [ptr, ec] = std::from_chars(cursor, end, value);
+        if (ec != std::errc{}) {
+            return false;
+        }
+        cursor = ptr;
+        return true;
+    }
+
+    // one line of a snap ("u v [w]", '#' or '%' comments) or dimacs ("a u v w", 'c' and 'p' lines)
+    // edge list, lines that hold no edge are skipped
+    template <typename V, typename W>
+    void parse_lines(const char* begin, const char* end, std::vector<Edge<V, W>>& out) {
+        while (begin < end) {
+            const char* line_end = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+            if (line_end == nullptr) {
+                line_end = end;
+            }
+            const char* cursor = begin;
+            begin = line_end + 1;
+
+            // '\r' too, so blank lines of crlf files count as empty
+            while (cursor < line_end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+                ++cursor;
+            }
+            if (cursor == line_end || *cursor == '#' || *cursor == '%' || *cursor == 'c' || *cursor == 'p') {
+                continue;
+            }
+            if (*cursor == 'a') {
+                ++cursor;
+            }
+
+            V from{}, to{};
+            W weight{1};
+            if (!parse_number(cursor, line_end, from) || !parse_number(cursor, line_end, to)) {
+                throw std::runtime_error("Malformed edge line: " + std::string(cursor, line_end));
+            }
+            parse_number(cursor, line_end, weight);
+            out.push_back({from, to, weight});
+        }
+    }
+}
+
+// parses a text edge list in parallel: the file is split into one chunk per worker at newline
+// boundaries, chunks are parsed independently and concatenated in file order
+template <Vertex V, Weight W>
+    requires std::is_arithmetic_v<V> && std::is_arithmetic_v<W>
+std::vector<Edge<V, W>> load_edge_list(const std::string& path, ThreadPool& pool) {
+    const MappedFile file(path);
+    const char* data = file.data();
+    const auto size = file.size();
+
+    const auto chunks = std::max<std::size_t>(1, std::min(pool.size(), size / 4096));
+    std::vector<std::size_t> bounds(chunks + 1, size);
+    bounds[0] = 0;
+    for (std::size_t c = 1; c < chunks; ++c) {
+        auto position = std::max(bounds[c - 1], size * c / chunks);
+        const auto* newline = position < size
+            ? static_cast<const char*>(std::memchr(data + position, '\n', size - position))
+            : nullptr;
+        bounds[c] = newline == nullptr ? size : static_cast<std::size_t>(newline - data) + 1;
+    }
+
+    std::vector<std::vector<Edge<V, W>>> parts(chunks);
+    pool.parallel_for(chunks, [&](std::size_t c, std::size_t) {
+        // rough guess of ~16 bytes per line keeps reallocation rare
+        parts[c].reserve((bounds[c + 1] - bounds[c]) / 16);
+        graph_io_detail::parse_lines(data + bounds[c], data + bounds[c + 1], parts[c]);
+    });
+
+    std::vector<std::size_t> starts(chunks + 1, 0);
+    for (std::size_t c = 0; c < chunks; ++c) {
+        starts[c + 1] = starts[c] + parts[c].size();
+    }
+    std::vector<Edge<V, W>> edges(starts.back());
+    pool.parallel_for(chunks, [&](std::size_t c, std::size_t) {
+        std::copy(parts[c].begin(), parts[c].end(), edges.begin() + starts[c]);
+    });
+    return edges;
+}
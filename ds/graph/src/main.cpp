@@ -1,11 +1,18 @@
 #include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <numeric>
+#include <optional>
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "graph.hpp"
@@ -13,7 +20,25 @@
 
 #include "adj_list.hpp"
 #include "adj_matrix.hpp"
+#include "apsp.hpp"
+#include "betweenness.hpp"
+#include "bfs.hpp"
+#include "components.hpp"
+#include "compressed.hpp"
+#include "csr.hpp"
+#include "distance_table.hpp"
+#include "dynamic.hpp"
 #include "edge_list.hpp"
+#include "flow.hpp"
+#include "generators.hpp"
+#include "graph_io.hpp"
+#include "mst.hpp"
+#include "pagerank.hpp"
+#include "partition.hpp"
+#include "query_server.hpp"
+#include "reorder.hpp"
+#include "thread_pool.hpp"
+#include "triangles.hpp"
 
 #if defined(_MSC_VER)
 #include <intrin.h>
@@ -120,6 +145,105 @@ std::vector<Edge<int, int>> gen_random_directed_graph(size_t n, double density,
     return edges;
 }
 
+// chung-lu style graph with a power-law degree distribution, vertex i is picked as an endpoint
+// with probability proportional to (i + 1)^(-1 / (exponent - 1))
+std::vector<Edge<int, int>> gen_power_law_directed_graph(size_t n, size_t avg_degree, double exponent = 2.1, int seed = 280131) {
+    if (n < 2) {
+        return {};
+    }
+
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> weight_dist(1, 100);
+
+    std::vector<double> vertex_weights(n);
+    for (size_t i = 0; i < n; ++i) {
+        vertex_weights[i] = std::pow(static_cast<double>(i + 1), -1.0 / (exponent - 1.0));
+    }
+    std::discrete_distribution<int> vertex_dist(vertex_weights.begin(), vertex_weights.end());
+
+    // hubs saturate quickly, so cap the target below the number of possible edges
+    const auto edge_count = std::min(n * avg_degree, n * (n - 1) / 2);
+    std::unordered_set<std::pair<int, int>, PairHash<int, int>> used;
+    std::vector<Edge<int, int>> edges;
+    edges.reserve(edge_count);
+    while (edges.size() < edge_count) {
+        const int from = vertex_dist(gen);
+        const int to = vertex_dist(gen);
+        if (from != to && used.insert({from, to}).second) {
+            edges.push_back({from, to, weight_dist(gen)});
+        }
+    }
+    return edges;
+}
+
+// correctness checks for the algorithms the suites time, every check prints its outcome and a
+// failure is reported without stopping the benchmarks
+size_t run_correctness_checks(ThreadPool& pool) {
+    size_t failures = 0;
+    auto check = [&](const std::string& name, bool passed) {
+        std::cout << std::format("check {}: {}\n", name, passed ? "ok" : "FAILED");
+        failures += passed ? 0 : 1;
+    };
+
+    // a negative self-loop is the whole negative cycle
+    const EdgeListGraph<int, int> self_loop({{1, 1, -1}, {1, 2, 3}});
+    const auto cycle = self_loop.find_negative_cycle();
+    check("negative self-loop cycle",
+        cycle && cycle->size() == 1 && cycle->front().from == 1 && cycle->front().to == 1);
+
+    // the generator guarantees a single weakly connected component at every density, the
+    // parallel run has to agree with the sequential one
+    for (const auto density : { 0.0, 0.1, 0.5 }) {
+        const CsrGraph<int, int> graph(gen_random_directed_graph(300, density));
+        const auto sequential = weakly_connected_components(graph);
+        const auto parallel = weakly_connected_components(graph, &pool);
+        check(std::format("WCC random graph [density: {}]", density),
+            sequential.count == 1 && parallel.count == 1 && sequential.component == parallel.component);
+    }
+
+    // a clique with low degree leaves hanging off pairs of its vertices, the short leaf rows are
+    // intersected with long clique rows by the galloping path. per vertex triangle counts against
+    // a brute force pass over the adjacency matrix
+    {
+        constexpr int CLIQUE = 80;
+        constexpr int LEAVES = 500;
+        std::vector<Edge<int, int>> edges;
+        for (int u = 0; u < CLIQUE; ++u) {
+            for (int v = u + 1; v < CLIQUE; ++v) {
+                edges.push_back({u, v, 1});
+            }
+        }
+        for (int leaf = 0; leaf < LEAVES; ++leaf) {
+            edges.push_back({CLIQUE + leaf, leaf % CLIQUE, 1});
+            edges.push_back({(leaf + 1) % CLIQUE, CLIQUE + leaf, 1});
+        }
+        const CsrGraph<int, int> graph(edges);
+        const auto n = graph.size();
+        std::vector<std::vector<bool>> adjacent(n, std::vector<bool>(n, false));
+        for (std::uint32_t u = 0; u < n; ++u) {
+            for (const auto v : graph.neighbors(u)) {
+                adjacent[u][v] = adjacent[v][u] = true;
+            }
+        }
+        std::vector<std::uint64_t> expected(n, 0);
+        for (std::uint32_t u = 0; u < n; ++u) {
+            for (auto v = u + 1; v < n; ++v) {
+                for (auto w = v + 1; w < n && adjacent[u][v]; ++w) {
+                    if (adjacent[u][w] && adjacent[v][w]) {
+                        ++expected[u];
+                        ++expected[v];
+                        ++expected[w];
+                    }
+                }
+            }
+        }
+        const auto clustering = clustering_coefficients(graph, &pool);
+        check("triangles per vertex clique with leaves", clustering.triangles == expected);
+    }
+
+    return failures;
+}
+
 int main() {
     const std::vector<size_t> sizes{ 50, 100, 200, 500 };
     const std::vector<double> densities{ 0.1, 0.25, 0.5, 0.7, 0.9, 1.0 };
@@ -137,6 +261,11 @@ int main() {
     constexpr size_t BATCH_SIZE = 10;
     BenchmarkSuite bench(WARMUP_ITERATIONS, TEST_ITERATIONS, BATCH_SIZE);
 
+    ThreadPool pool;
+    if (const auto failures = run_correctness_checks(pool); failures > 0) {
+        std::cerr << std::format("{} correctness checks failed\n", failures);
+    }
+
     for (const auto& [params, edges] : precomputed_graphs) {
         const auto& [size, density] = params;
         const auto real_size = size * (size - 1);
@@ -171,6 +300,21 @@ int main() {
         );
         bench.run_test(edge_list_dijkstra_bench);
 
+        BenchmarkTest<EdgeListGraph<int, int>> edge_list_indexed_dijkstra_bench(
+            std::format("Dijkstra EdgeList (indexed) - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return EdgeListGraph<int, int>(edges, true);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                const auto start = random_vertices[iteration % random_vertices.size()];
+                const auto end = random_vertices[(iteration + 1) % random_vertices.size()];
+                const auto path = graph.dijkstra(start, end);
+                black_box(path);
+            }
+        );
+        bench.run_test(edge_list_indexed_dijkstra_bench);
+
         BenchmarkTest<AdjListGraph<int, int>> adj_list_dijkstra_bench(
             std::format("Dijkstra AdjList - {} edges [density: {}]", real_size, density),
             real_size,
@@ -186,6 +330,21 @@ int main() {
         );
         bench.run_test(adj_list_dijkstra_bench);
 
+        BenchmarkTest<AdjListGraph<int, int>> adj_list_dijkstra_context_bench(
+            std::format("Dijkstra AdjList (reused context) - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjListGraph<int, int>(edges);
+            },
+            [random_vertices, context = SearchContext<int, int>{}](auto& graph, size_t iteration) mutable {
+                const auto start = random_vertices[iteration % random_vertices.size()];
+                const auto end = random_vertices[(iteration + 1) % random_vertices.size()];
+                const auto path = graph.dijkstra(start, end, context);
+                black_box(path);
+            }
+        );
+        bench.run_test(adj_list_dijkstra_context_bench);
+
         BenchmarkTest<AdjMatrixGraph<int, int>> adj_matrix_dijkstra_bench(
             std::format("Dijkstra AdjMatrix - {} edges [density: {}]", real_size, density),
             real_size,
@@ -201,6 +360,306 @@ int main() {
         );
         bench.run_test(adj_matrix_dijkstra_bench);
 
+        BenchmarkTest<CompressedGraph<int, int>> compressed_dijkstra_bench(
+            std::format("Dijkstra Compressed - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return CompressedGraph<int, int>(edges);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                const auto start = random_vertices[iteration % random_vertices.size()];
+                const auto end = random_vertices[(iteration + 1) % random_vertices.size()];
+                const auto path = graph.dijkstra(start, end);
+                black_box(path);
+            }
+        );
+        bench.run_test(compressed_dijkstra_bench);
+
+        // the same queries through the GraphView templates, no virtual calls or per row copies
+        BenchmarkTest<AdjListGraph<int, int>> adj_list_view_dijkstra_bench(
+            std::format("Dijkstra AdjList (GraphView) - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjListGraph<int, int>(edges);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                const auto start = random_vertices[iteration % random_vertices.size()];
+                const auto end = random_vertices[(iteration + 1) % random_vertices.size()];
+                const auto path = dijkstra(graph, start, end);
+                black_box(path);
+            }
+        );
+        bench.run_test(adj_list_view_dijkstra_bench);
+
+        BenchmarkTest<AdjMatrixGraph<int, int>> adj_matrix_view_dijkstra_bench(
+            std::format("Dijkstra AdjMatrix (GraphView) - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjMatrixGraph<int, int>(edges);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                const auto start = random_vertices[iteration % random_vertices.size()];
+                const auto end = random_vertices[(iteration + 1) % random_vertices.size()];
+                const auto path = dijkstra(graph, start, end);
+                black_box(path);
+            }
+        );
+        bench.run_test(adj_matrix_view_dijkstra_bench);
+
+        BenchmarkTest<CompressedGraph<int, int>> compressed_view_dijkstra_bench(
+            std::format("Dijkstra Compressed (GraphView) - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return CompressedGraph<int, int>(edges);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                const auto start = random_vertices[iteration % random_vertices.size()];
+                const auto end = random_vertices[(iteration + 1) % random_vertices.size()];
+                const auto path = dijkstra(graph, start, end);
+                black_box(path);
+            }
+        );
+        bench.run_test(compressed_view_dijkstra_bench);
+
+        // vertex removal including incident edges, full scans against the in-edge index
+        BenchmarkTest<AdjListGraph<int, int>> adj_list_remove_vertex_bench(
+            std::format("Remove vertex AdjList - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjListGraph<int, int>(edges);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                black_box(graph.remove_vertex(random_vertices[iteration % random_vertices.size()]));
+            }
+        );
+        bench.run_test(adj_list_remove_vertex_bench);
+
+        BenchmarkTest<AdjListGraph<int, int>> adj_list_indexed_remove_vertex_bench(
+            std::format("Remove vertex AdjList (in-edge index) - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjListGraph<int, int>(edges, true);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                black_box(graph.remove_vertex(random_vertices[iteration % random_vertices.size()]));
+            }
+        );
+        bench.run_test(adj_list_indexed_remove_vertex_bench);
+
+        BenchmarkTest<AdjMatrixGraph<int, int>> adj_matrix_remove_vertex_bench(
+            std::format("Remove vertex AdjMatrix - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjMatrixGraph<int, int>(edges);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                black_box(graph.remove_vertex(random_vertices[iteration % random_vertices.size()]));
+            }
+        );
+        bench.run_test(adj_matrix_remove_vertex_bench);
+
+        BenchmarkTest<AdjMatrixGraph<int, int>> adj_matrix_indexed_remove_vertex_bench(
+            std::format("Remove vertex AdjMatrix (in-edge index) - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjMatrixGraph<int, int>(edges, true);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                black_box(graph.remove_vertex(random_vertices[iteration % random_vertices.size()]));
+            }
+        );
+        bench.run_test(adj_matrix_indexed_remove_vertex_bench);
+
+        // point lookups, hash probes and row scans against a single dense matrix read
+        constexpr size_t LOOKUPS = 1000;
+        BenchmarkTest<AdjListGraph<int, int>> adj_list_lookup_bench(
+            std::format("Edge lookup AdjList - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjListGraph<int, int>(edges);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                for (size_t i = 0; i < LOOKUPS; ++i) {
+                    const auto from = random_vertices[(iteration + i) % random_vertices.size()];
+                    const auto to = random_vertices[(iteration + 2 * i + 1) % random_vertices.size()];
+                    black_box(graph.get_weight(from, to));
+                }
+            }
+        );
+        bench.run_test(adj_list_lookup_bench);
+
+        BenchmarkTest<AdjMatrixGraph<int, int>> adj_matrix_lookup_bench(
+            std::format("Edge lookup AdjMatrix - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjMatrixGraph<int, int>(edges);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                for (size_t i = 0; i < LOOKUPS; ++i) {
+                    const auto from = random_vertices[(iteration + i) % random_vertices.size()];
+                    const auto to = random_vertices[(iteration + 2 * i + 1) % random_vertices.size()];
+                    black_box(graph.get_weight(from, to));
+                }
+            }
+        );
+        bench.run_test(adj_matrix_lookup_bench);
+
+        // many-to-many distances, one early-terminating search per source instead of one per pair
+        constexpr size_t TABLE_SIZE = 16;
+        const std::vector<int> table_sources(random_vertices.begin(), random_vertices.begin() + std::min(TABLE_SIZE, random_vertices.size()));
+        const std::vector<int> table_targets(random_vertices.rbegin(), random_vertices.rbegin() + std::min(TABLE_SIZE, random_vertices.size()));
+
+        BenchmarkTest<AdjListGraph<int, int>> adj_list_table_bench(
+            std::format("Distance table {}x{} AdjList - {} edges [density: {}]", TABLE_SIZE, TABLE_SIZE, real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjListGraph<int, int>(edges);
+            },
+            [&pool, table_sources, table_targets](auto& graph, size_t) {
+                const auto table = distance_table(graph, table_sources, table_targets, pool);
+                black_box(table);
+            }
+        );
+        bench.run_test(adj_list_table_bench);
+
+        BenchmarkTest<AdjMatrixGraph<int, int>> adj_matrix_apsp_bench(
+            std::format("APSP Floyd-Warshall AdjMatrix - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjMatrixGraph<int, int>(edges);
+            },
+            [&pool](auto& graph, size_t) {
+                const auto distances = all_pairs_shortest_paths(graph, pool);
+                black_box(distances);
+            }
+        );
+        bench.run_test(adj_matrix_apsp_bench);
+
+        // johnson is the sparse counterpart of floyd-warshall
+        if (density <= 0.1) {
+            BenchmarkTest<AdjListGraph<int, int>> adj_list_johnson_bench(
+                std::format("APSP Johnson AdjList - {} edges [density: {}]", real_size, density),
+                real_size,
+                [edges](size_t) {
+                    return AdjListGraph<int, int>(edges);
+                },
+                [&pool](auto& graph, size_t) {
+                    const auto distances = johnson(graph, pool);
+                    black_box(distances);
+                }
+            );
+            bench.run_test(adj_list_johnson_bench);
+        }
+
+        // hop counts, direction-optimizing bfs against dijkstra with unit weights
+        const CsrGraph<int, int> csr_graph(edges);
+        Bfs<int, int> bfs(csr_graph);
+
+        BenchmarkTest<int> csr_bfs_bench(
+            std::format("BFS CSR - {} edges [density: {}]", real_size, density),
+            real_size,
+            [](size_t) {
+                return 0;
+            },
+            [&bfs, random_vertices](auto&, size_t iteration) {
+                const auto& depths = bfs.run(random_vertices[iteration % random_vertices.size()]);
+                black_box(depths);
+            }
+        );
+        bench.run_test(csr_bfs_bench);
+
+        BenchmarkTest<int> csr_parallel_bfs_bench(
+            std::format("BFS CSR parallel - {} edges [density: {}]", real_size, density),
+            real_size,
+            [](size_t) {
+                return 0;
+            },
+            [&bfs, &pool, random_vertices](auto&, size_t iteration) {
+                const auto& depths = bfs.run(random_vertices[iteration % random_vertices.size()], &pool);
+                black_box(depths);
+            }
+        );
+        bench.run_test(csr_parallel_bfs_bench);
+
+        // the generator guarantees a single weakly connected component
+        BenchmarkTest<int> csr_wcc_bench(
+            std::format("WCC CSR parallel - {} edges [density: {}]", real_size, density),
+            real_size,
+            [](size_t) {
+                return 0;
+            },
+            [&csr_graph, &pool](auto&, size_t) {
+                const auto components = weakly_connected_components(csr_graph, &pool);
+                black_box(components);
+            }
+        );
+        bench.run_test(csr_wcc_bench);
+
+        BenchmarkTest<int> csr_tarjan_bench(
+            std::format("SCC Tarjan CSR - {} edges [density: {}]", real_size, density),
+            real_size,
+            [](size_t) {
+                return 0;
+            },
+            [&csr_graph](auto&, size_t) {
+                const auto components = strongly_connected_components(csr_graph);
+                black_box(components);
+            }
+        );
+        bench.run_test(csr_tarjan_bench);
+
+        BenchmarkTest<int> csr_fwbw_bench(
+            std::format("SCC forward-backward CSR parallel - {} edges [density: {}]", real_size, density),
+            real_size,
+            [](size_t) {
+                return 0;
+            },
+            [&csr_graph, &pool](auto&, size_t) {
+                const auto components = strongly_connected_components(csr_graph, pool);
+                black_box(components);
+            }
+        );
+        bench.run_test(csr_fwbw_bench);
+
+        BenchmarkTest<EdgeListGraph<int, int>> edge_list_kruskal_bench(
+            std::format("MST Kruskal EdgeList parallel - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return EdgeListGraph<int, int>(edges);
+            },
+            [&pool](auto& graph, size_t) {
+                const auto forest = minimum_spanning_forest(graph, &pool);
+                black_box(forest);
+            }
+        );
+        bench.run_test(edge_list_kruskal_bench);
+
+        BenchmarkTest<int> csr_boruvka_bench(
+            std::format("MST Boruvka CSR parallel - {} edges [density: {}]", real_size, density),
+            real_size,
+            [](size_t) {
+                return 0;
+            },
+            [&csr_graph, &pool](auto&, size_t) {
+                const auto forest = boruvka_minimum_spanning_forest(csr_graph, &pool);
+                black_box(forest);
+            }
+        );
+        bench.run_test(csr_boruvka_bench);
+
+        BenchmarkTest<int> csr_pagerank_bench(
+            std::format("PageRank CSR parallel - {} edges [density: {}]", real_size, density),
+            real_size,
+            [](size_t) {
+                return 0;
+            },
+            [&csr_graph, &pool](auto&, size_t) {
+                const auto ranks = pagerank(csr_graph, pool);
+                black_box(ranks);
+            }
+        );
+        bench.run_test(csr_pagerank_bench);
+
         // Bellman-Ford benchmarks for all graph types
         BenchmarkTest<EdgeListGraph<int, int>> edge_list_bellman_bench(
             std::format("Bellman-Ford EdgeList - {} edges [density: {}]", real_size, density),
@@ -246,9 +705,539 @@ int main() {
             }
         );
         bench.run_test(adj_matrix_bellman_bench);
+
+        BenchmarkTest<AdjListGraph<int, int>> adj_list_view_bellman_bench(
+            std::format("Bellman-Ford AdjList (GraphView) - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjListGraph<int, int>(edges);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                const auto start = random_vertices[iteration % random_vertices.size()];
+                const auto end = random_vertices[(iteration + 1) % random_vertices.size()];
+                const auto path = bellman_ford(graph, start, end, false);
+                black_box(path);
+            }
+        );
+        bench.run_test(adj_list_view_bellman_bench);
+
+        BenchmarkTest<AdjMatrixGraph<int, int>> adj_matrix_view_bellman_bench(
+            std::format("Bellman-Ford AdjMatrix (GraphView) - {} edges [density: {}]", real_size, density),
+            real_size,
+            [edges](size_t) {
+                return AdjMatrixGraph<int, int>(edges);
+            },
+            [random_vertices](auto& graph, size_t iteration) {
+                const auto start = random_vertices[iteration % random_vertices.size()];
+                const auto end = random_vertices[(iteration + 1) % random_vertices.size()];
+                const auto path = bellman_ford(graph, start, end, false);
+                black_box(path);
+            }
+        );
+        bench.run_test(adj_matrix_view_bellman_bench);
+
+        // the same edges oriented from lower to higher id form a dag, weights shifted to go negative
+        std::vector<Edge<int, int>> dag_edges;
+        dag_edges.reserve(edges.size());
+        for (const auto& edge : edges) {
+            if (edge.from != edge.to) {
+                dag_edges.push_back({std::min(edge.from, edge.to), std::max(edge.from, edge.to), edge.weight % 21 - 10});
+            }
+        }
+        const AdjListGraph<int, int> dag_graph(dag_edges);
+        for (const bool detect_dag : {false, true}) {
+            BenchmarkTest<int> dag_bellman_bench(
+                std::format("Bellman-Ford AdjList DAG ({}) - {} edges [density: {}]", detect_dag ? "topological pass" : "rounds", dag_edges.size(), density),
+                dag_edges.size(),
+                [](size_t) {
+                    return 0;
+                },
+                [&dag_graph, &random_vertices, detect_dag](auto&, size_t iteration) {
+                    const auto start = random_vertices[iteration % random_vertices.size()];
+                    const auto end = random_vertices[(iteration + 1) % random_vertices.size()];
+                    const auto path = bellman_ford(dag_graph, std::min(start, end), std::max(start, end), false, detect_dag);
+                    black_box(path);
+                }
+            );
+            bench.run_test(dag_bellman_bench);
+        }
+
+        BenchmarkTest<int> topological_order_bench(
+            std::format("Topological order AdjList DAG - {} edges [density: {}]", dag_edges.size(), density),
+            dag_edges.size(),
+            [](size_t) {
+                return 0;
+            },
+            [&dag_graph](auto&, size_t) {
+                const auto order = topological_order(dag_graph);
+                black_box(order);
+            }
+        );
+        bench.run_test(topological_order_bench);
+    }
+
+    // iterative ranking on skewed degree distributions
+    for (const auto& size : { 10000u, 50000u }) {
+        constexpr size_t AVG_DEGREE = 16;
+        const auto edges = gen_power_law_directed_graph(size, AVG_DEGREE);
+        const CsrGraph<int, int> csr_graph(edges);
+        const PullEngine<int, int> engine(csr_graph, pool);
+
+        BenchmarkTest<int> power_law_pagerank_bench(
+            std::format("PageRank CSR parallel power-law - {} edges [vertices: {}]", edges.size(), size),
+            edges.size(),
+            [](size_t) {
+                return 0;
+            },
+            [&engine](auto&, size_t) {
+                const auto ranks = engine.pagerank();
+                black_box(ranks);
+            }
+        );
+        bench.run_test(power_law_pagerank_bench);
+
+        // loading the same graph back from disk, text through the parallel parser and binary via mmap
+        // copied into an owning CsrGraph
+        const auto text_path = std::format("graph_{}.txt", size);
+        const auto binary_path = std::format("graph_{}.bin", size);
+        {
+            std::ofstream text(text_path);
+            for (const auto& edge : edges) {
+                text << edge.from << ' ' << edge.to << ' ' << edge.weight << '\n';
+            }
+        }
+        write_binary_graph(binary_path, csr_graph);
+
+        BenchmarkTest<int> text_load_bench(
+            std::format("Load text edge list parallel - {} edges [vertices: {}]", edges.size(), size),
+            edges.size(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                const auto loaded = load_edge_list<int, int>(text_path, pool);
+                black_box(loaded);
+            }
+        );
+        bench.run_test(text_load_bench);
+
+        BenchmarkTest<int> binary_load_bench(
+            std::format("Load binary CSR mmap to_csr - {} edges [vertices: {}]", edges.size(), size),
+            edges.size(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                // mapping alone touches no page, copying every section does the work the parser does
+                const MappedGraph<int, int> loaded(binary_path);
+                const auto graph = loaded.to_csr();
+                black_box(graph.edge_count());
+            }
+        );
+        bench.run_test(binary_load_bench);
+
+        BenchmarkTest<int> binary_compress_bench(
+            std::format("Compress binary CSR mmap - {} edges [vertices: {}]", edges.size(), size),
+            edges.size(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                // rows are encoded off the mapping, no CsrGraph is materialized in between
+                const MappedGraph<int, int> loaded(binary_path);
+                const CompressedGraph<int, int> compressed(loaded);
+                black_box(compressed.encoded_bytes());
+            }
+        );
+        bench.run_test(binary_compress_bench);
+
+        std::remove(text_path.c_str());
+        std::remove(binary_path.c_str());
     }
 
     bench.write_results("benchmark_results.csv");
+
+    // million vertex graphs from the streaming generators, few iterations since every run is long
+    BenchmarkSuite large_bench(1, 5, 1);
+    constexpr unsigned LARGE_SCALE = 20;
+    constexpr size_t LARGE_DEGREE = 8;
+    constexpr size_t LARGE_VERTICES = size_t{1} << LARGE_SCALE;
+    constexpr size_t GRID_SIDE = size_t{1} << (LARGE_SCALE / 2);
+
+    const std::vector<std::pair<std::string, std::function<CsrGraph<int, int>()>>> large_generators{
+        {"G(n,p)", [&] { return erdos_renyi_graph(LARGE_VERTICES, static_cast<double>(LARGE_DEGREE) / LARGE_VERTICES, &pool); }},
+        {"R-MAT", [&] { return rmat_graph(LARGE_SCALE, LARGE_DEGREE, &pool); }},
+        {"road grid", [&] { return grid_graph(GRID_SIDE, GRID_SIDE, 0.9, &pool); }},
+    };
+    for (const auto& [name, generate] : large_generators) {
+        BenchmarkTest<int> generate_bench(
+            std::format("Generate {} CSR parallel [vertices: {}]", name, LARGE_VERTICES),
+            LARGE_VERTICES,
+            [](size_t) {
+                return 0;
+            },
+            [&generate](auto&, size_t) {
+                const auto graph = generate();
+                black_box(graph.edge_count());
+            }
+        );
+        large_bench.run_test(generate_bench);
+
+        const auto csr_graph = generate();
+        Bfs<int, int> bfs(csr_graph);
+        BenchmarkTest<int> large_bfs_bench(
+            std::format("BFS CSR parallel {} - {} edges [vertices: {}]", name, csr_graph.edge_count(), LARGE_VERTICES),
+            csr_graph.edge_count(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                const auto& depths = bfs.run(0, &pool);
+                black_box(depths);
+            }
+        );
+        large_bench.run_test(large_bfs_bench);
+
+        // full neighbor scan, plain CSR arrays against group varint decoding
+        const CompressedGraph<int, int> compressed(csr_graph);
+        std::cout << std::format("{} CSR arrays: {} bytes, compressed: {} bytes\n", name,
+            csr_graph.edge_count() * (sizeof(std::uint32_t) + sizeof(int)) + (csr_graph.size() + 1) * sizeof(size_t) + csr_graph.size() * sizeof(int),
+            compressed.encoded_bytes());
+
+        BenchmarkTest<int> csr_scan_bench(
+            std::format("Neighbor scan CSR {} - {} edges [vertices: {}]", name, csr_graph.edge_count(), LARGE_VERTICES),
+            csr_graph.edge_count(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                std::uint64_t sum = 0;
+                for (std::uint32_t u = 0; u < csr_graph.size(); ++u) {
+                    const auto targets = csr_graph.neighbors(u);
+                    const auto weights = csr_graph.neighbor_weights(u);
+                    for (size_t i = 0; i < targets.size(); ++i) {
+                        sum += targets[i] + weights[i];
+                    }
+                }
+                black_box(sum);
+            }
+        );
+        large_bench.run_test(csr_scan_bench);
+
+        BenchmarkTest<int> compressed_scan_bench(
+            std::format("Neighbor scan Compressed {} - {} edges [vertices: {}]", name, compressed.edge_count(), LARGE_VERTICES),
+            compressed.edge_count(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                std::uint64_t sum = 0;
+                for (std::uint32_t u = 0; u < compressed.size(); ++u) {
+                    compressed.for_each_neighbor(u, [&](std::uint32_t target, int weight) {
+                        sum += target + weight;
+                    });
+                }
+                black_box(sum);
+            }
+        );
+        large_bench.run_test(compressed_scan_bench);
+
+        // mutable adjacency rows in each layout, 32-bit targets with the weights packed, split or dropped
+        const auto large_edges = csr_graph.get_edges();
+        auto scan_adj_list = [&](const auto& graph, const std::string& layout) {
+            std::cout << std::format("{} AdjList {} rows: {} bytes\n", name, layout, graph.adjacency_bytes());
+            BenchmarkTest<int> adj_list_scan_bench(
+                std::format("Neighbor scan AdjList ({}) {} - {} edges [vertices: {}]", layout, name, large_edges.size(), LARGE_VERTICES),
+                large_edges.size(),
+                [](size_t) {
+                    return 0;
+                },
+                [&](auto&, size_t) {
+                    std::uint64_t sum = 0;
+                    graph.for_each_vertex([&](std::uint32_t u) {
+                        graph.for_each_neighbor(u, [&](std::uint32_t target, int weight) {
+                            sum += target + weight;
+                        });
+                    });
+                    black_box(sum);
+                }
+            );
+            large_bench.run_test(adj_list_scan_bench);
+        };
+        scan_adj_list(AdjListGraph<int, int, AdjacencyLayout::Packed>(large_edges), "packed");
+        scan_adj_list(AdjListGraph<int, int, AdjacencyLayout::Split>(large_edges), "split");
+        scan_adj_list(AdjListGraph<int, int, AdjacencyLayout::Unweighted>(large_edges), "unweighted");
+
+        // triangles on the degree ordered orientation, the undirected view of the generated edges
+        BenchmarkTest<int> triangle_bench(
+            std::format("Triangle count CSR parallel {} - {} edges [vertices: {}]", name, csr_graph.edge_count(), LARGE_VERTICES),
+            csr_graph.edge_count(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                black_box(count_triangles(csr_graph, &pool));
+            }
+        );
+        large_bench.run_test(triangle_bench);
+
+        const auto clustering = clustering_coefficients(csr_graph, &pool);
+        std::cout << std::format("{} triangles: {}, average clustering: {:.4f}, transitivity: {:.4f}\n",
+            name, clustering.total, clustering.average, clustering.transitivity);
+        BenchmarkTest<int> clustering_bench(
+            std::format("Clustering coefficients CSR parallel {} - {} edges [vertices: {}]", name, csr_graph.edge_count(), LARGE_VERTICES),
+            csr_graph.edge_count(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                const auto result = clustering_coefficients(csr_graph, &pool);
+                black_box(result.coefficients);
+            }
+        );
+        large_bench.run_test(clustering_bench);
+
+        // multilevel partition into shards against hashing ids onto them
+        constexpr std::uint32_t SHARDS = 16;
+        BenchmarkTest<int> partition_bench(
+            std::format("Partition {} parts CSR parallel {} - {} edges [vertices: {}]", SHARDS, name, csr_graph.edge_count(), LARGE_VERTICES),
+            csr_graph.edge_count(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                const auto result = partition(csr_graph, SHARDS, &pool);
+                black_box(result.edge_cut);
+            }
+        );
+        large_bench.run_test(partition_bench);
+
+        const auto sharded = partition(csr_graph, SHARDS, &pool);
+        size_t hash_cut = 0;
+        for (std::uint32_t u = 0; u < csr_graph.size(); ++u) {
+            for (const auto v : csr_graph.neighbors(u)) {
+                hash_cut += u % SHARDS != v % SHARDS;
+            }
+        }
+        std::cout << std::format("{} {} parts: edge cut {} ({:.2f}%), hashed {} ({:.2f}%), balance {:.3f}\n", name, SHARDS,
+            sharded.edge_cut, 100.0 * sharded.edge_cut / csr_graph.edge_count(),
+            hash_cut, 100.0 * hash_cut / csr_graph.edge_count(), sharded.balance);
+    }
+
+    // traversal kernels before and after relabeling the randomly numbered R-MAT vertices
+    constexpr unsigned REORDER_SCALE = 18;
+    const auto rmat = rmat_graph(REORDER_SCALE, LARGE_DEGREE, &pool);
+    const std::vector<std::pair<std::string, std::optional<ReorderStrategy>>> strategies{
+        {"original", std::nullopt},
+        {"RCM", ReorderStrategy::ReverseCuthillMcKee},
+        {"degree sort", ReorderStrategy::DegreeSort},
+        {"hub cluster", ReorderStrategy::HubCluster},
+        {"Gorder", ReorderStrategy::Gorder},
+    };
+    for (const auto& [name, strategy] : strategies) {
+        if (strategy) {
+            BenchmarkTest<int> reorder_bench(
+                std::format("Reorder {} R-MAT - {} edges [vertices: {}]", name, rmat.edge_count(), rmat.size()),
+                rmat.edge_count(),
+                [](size_t) {
+                    return 0;
+                },
+                [&](auto&, size_t) {
+                    const auto reordered = reorder(rmat, *strategy, &pool);
+                    black_box(reordered.edge_count());
+                }
+            );
+            large_bench.run_test(reorder_bench);
+        }
+
+        const auto graph = strategy ? reorder(rmat, *strategy, &pool) : rmat;
+        Bfs<int, int> bfs(graph);
+        BenchmarkTest<int> ordered_bfs_bench(
+            std::format("BFS CSR parallel R-MAT {} order - {} edges [vertices: {}]", name, graph.edge_count(), graph.size()),
+            graph.edge_count(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                const auto& depths = bfs.run(rmat.label(0), &pool);
+                black_box(depths);
+            }
+        );
+        large_bench.run_test(ordered_bfs_bench);
+
+        const PullEngine<int, int> engine(graph, pool);
+        BenchmarkTest<int> ordered_pagerank_bench(
+            std::format("PageRank CSR parallel R-MAT {} order - {} edges [vertices: {}]", name, graph.edge_count(), graph.size()),
+            graph.edge_count(),
+            [](size_t) {
+                return 0;
+            },
+            [&engine](auto&, size_t) {
+                const auto ranks = engine.pagerank();
+                black_box(ranks);
+            }
+        );
+        large_bench.run_test(ordered_pagerank_bench);
+    }
+
+    // sampled brandes betweenness, one bfs or dijkstra pass per sampled source spread over the pool
+    constexpr size_t BETWEENNESS_SAMPLES = 64;
+    Betweenness<int, int> betweenness(rmat, &pool);
+    for (const bool weighted : {false, true}) {
+        BenchmarkTest<int> betweenness_bench(
+            std::format("Betweenness {} CSR parallel R-MAT {} sources - {} edges [vertices: {}]",
+                weighted ? "Dijkstra" : "BFS", BETWEENNESS_SAMPLES, rmat.edge_count(), rmat.size()),
+            rmat.edge_count(),
+            [](size_t) {
+                return 0;
+            },
+            [&, weighted](auto&, size_t iteration) {
+                const auto scores = betweenness.run({weighted, BETWEENNESS_SAMPLES, iteration});
+                black_box(scores);
+            }
+        );
+        large_bench.run_test(betweenness_bench);
+    }
+
+    // traffic on a road grid: every batch rescales the weights of random streets and closes or opens
+    // a few of them, the maintained tree is repaired against a dijkstra from scratch after the same batch
+    constexpr size_t ROAD_SIDE = 256;
+    const auto road_edges = grid_graph(ROAD_SIDE, ROAD_SIDE, 0.9, &pool).get_edges();
+    for (const size_t batch_size : {10, 100, 1000}) {
+        auto make_batch = [&road_edges, batch_size](size_t iteration) {
+            std::mt19937 rng(static_cast<std::uint32_t>(iteration * 7919 + batch_size));
+            std::uniform_int_distribution<size_t> pick(0, road_edges.size() - 1);
+            std::uniform_int_distribution<int> factor(50, 200);
+            std::vector<EdgeUpdate<int, int>> batch;
+            batch.reserve(batch_size);
+            for (size_t i = 0; i < batch_size; ++i) {
+                const auto& edge = road_edges[pick(rng)];
+                if (i % 20 == 19) {
+                    batch.push_back({edge.from, edge.to, std::nullopt});
+                } else {
+                    batch.push_back({edge.from, edge.to, std::max(1, edge.weight * factor(rng) / 100)});
+                }
+            }
+            return batch;
+        };
+
+        AdjListGraph<int, int> incremental_graph(road_edges, true);
+        DynamicShortestPaths<int, int> shortest_paths(incremental_graph, 0);
+        size_t repair_iteration = 0;
+        BenchmarkTest<int> repair_bench(
+            std::format("SSSP repair AdjList road grid - batch of {} [vertices: {}]", batch_size, ROAD_SIDE * ROAD_SIDE),
+            batch_size,
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                shortest_paths.apply_batch(make_batch(repair_iteration++));
+                black_box(shortest_paths.last_settled());
+            }
+        );
+        large_bench.run_test(repair_bench);
+
+        AdjListGraph<int, int> recompute_graph(road_edges, true);
+        size_t recompute_iteration = 0;
+        SearchContext<int, int> context;
+        BenchmarkTest<int> recompute_bench(
+            std::format("SSSP recompute AdjList road grid - batch of {} [vertices: {}]", batch_size, ROAD_SIDE * ROAD_SIDE),
+            batch_size,
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                recompute_graph.apply_batch(make_batch(recompute_iteration++));
+                const auto tree = recompute_graph.shortest_path_tree(0, context);
+                black_box(tree);
+            }
+        );
+        large_bench.run_test(recompute_bench);
+    }
+
+    // concurrent point to point queries on the road grid, one batch per iteration and the pool
+    // doubled up to the core count
+    const AdjListGraph<int, int> road_graph(road_edges);
+    constexpr size_t QUERY_BATCH = 256;
+    std::vector<std::pair<int, int>> road_queries;
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> pick(0, static_cast<int>(ROAD_SIDE * ROAD_SIDE) - 1);
+        for (size_t i = 0; i < QUERY_BATCH; ++i) {
+            road_queries.push_back({pick(rng), pick(rng)});
+        }
+    }
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1;; threads = std::min(threads * 2, cores)) {
+        ThreadPool query_pool(threads);
+        QueryServer<int, int> server(road_graph, query_pool);
+        BenchmarkTest<int> query_bench(
+            std::format("Dijkstra batch AdjList road grid - {} threads [queries: {}]", threads, QUERY_BATCH),
+            QUERY_BATCH,
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                const auto paths = server.dijkstra_batch(road_queries);
+                black_box(paths);
+            }
+        );
+        const auto result = large_bench.run_test(query_bench);
+        std::cout << std::format("{} threads: {:.0f} queries/s\n", threads, QUERY_BATCH * 1e6 / result.avg_time_us);
+        if (threads == cores) {
+            break;
+        }
+    }
+    // the same batch through the free function, which starts a pool and workspaces every call
+    BenchmarkTest<int> one_off_query_bench(
+        std::format("Dijkstra one-off batch AdjList road grid - {} threads [queries: {}]", cores, QUERY_BATCH),
+        QUERY_BATCH,
+        [](size_t) {
+            return 0;
+        },
+        [&](auto&, size_t) {
+            const auto paths = dijkstra_batch(road_graph, road_queries, cores);
+            black_box(paths);
+        }
+    );
+    large_bench.run_test(one_off_query_bench);
+
+    // max flow between opposite corners of the road grid and between the two largest R-MAT hubs,
+    // the residual network is built once and every run starts from zero flow
+    auto hubs = [](const CsrGraph<int, int>& graph) {
+        std::uint32_t first = 0, second = 1;
+        for (std::uint32_t u = 0; u < graph.size(); ++u) {
+            if (graph.degree(u) > graph.degree(first)) {
+                second = first;
+                first = u;
+            } else if (u != first && graph.degree(u) > graph.degree(second)) {
+                second = u;
+            }
+        }
+        return std::pair{graph.label(first), graph.label(second)};
+    };
+    const auto road_csr = CsrGraph<int, int>(road_edges);
+    const std::vector<std::tuple<std::string, const CsrGraph<int, int>*, std::pair<int, int>>> flow_cases{
+        {"road grid", &road_csr, {road_csr.label(0), road_csr.label(road_csr.size() - 1)}},
+        {"R-MAT", &rmat, hubs(rmat)},
+    };
+    for (const auto& [name, graph, endpoints] : flow_cases) {
+        FlowNetwork<int, int> network(*graph);
+        BenchmarkTest<int> max_flow_bench(
+            std::format("Max flow push-relabel {} - {} edges [vertices: {}]", name, graph->edge_count(), graph->size()),
+            graph->edge_count(),
+            [](size_t) {
+                return 0;
+            },
+            [&](auto&, size_t) {
+                const auto result = network.max_flow(endpoints.first, endpoints.second);
+                black_box(result->value);
+            }
+        );
+        large_bench.run_test(max_flow_bench);
+    }
+
+    large_bench.write_results("benchmark_results_large.csv");
     
     // try {
     //     const auto edges = gen_random_directed_graph(500, 0.5);
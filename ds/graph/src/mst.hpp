@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "csr.hpp"
+#include "thread_pool.hpp"
+
+// sequential union-find with path halving and union by size
+class DisjointSets {
+    std::vector<std::size_t> parent;
+    std::vector<std::size_t> size;
+
+public:
+    explicit DisjointSets(std::size_t n)
+        : parent(n),
+          size(n, 1)
+    {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+
+    std::size_t find(std::size_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    // no path compression, safe to call concurrently while nothing is united
+    std::size_t find_root(std::size_t x) const {
+        while (parent[x] != x) {
+            x = parent[x];
+        }
+        return x;
+    }
+
+    bool unite(std::size_t a, std::size_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) {
+            return false;
+        }
+        if (size[a] < size[b]) {
+            std::swap(a, b);
+        }
+        parent[b] = a;
+        size[a] += size[b];
+        return true;
+    }
+};
+
+namespace mst_detail {
+    // order preserving unsigned key, the sign bit is flipped so negative weights sort first
+    template <std::integral W>
+    auto radix_key(W weight) {
+        using U = std::make_unsigned_t<W>;
+        auto key = static_cast<U>(weight);
+        if constexpr (std::is_signed_v<W>) {
+            key ^= U{1} << (sizeof(U) * 8 - 1);
+        }
+        return key;
+    }
+
+    // stable lsd radix sort of edges by weight, one byte per pass, every pass builds per-chunk
+    // histograms and scatters the chunks in parallel, passes where all keys share a digit are skipped
+    template <Vertex V, Weight W>
+        requires std::integral<W>
+    void sort_by_weight(std::vector<Edge<V, W>>& edges, ThreadPool* pool) {
+        constexpr std::size_t CHUNK = 1 << 16;
+        const auto n = edges.size();
+        const auto chunks = std::max<std::size_t>(1, (n + CHUNK - 1) / CHUNK);
+
+        std::vector<Edge<V, W>> buffer(edges);
+        std::vector<std::array<std::size_t, 256>> histograms(chunks);
+
+        for (std::size_t pass = 0; pass < sizeof(W); ++pass) {
+            const auto shift = pass * 8;
+            auto digit = [shift](const Edge<V, W>& edge) {
+                return static_cast<std::size_t>((radix_key(edge.weight) >> shift) & 0xff);
+            };
+
+            parallel_chunks(pool, chunks, 1, [&](std::size_t chunk, std::size_t) {
+                auto& histogram = histograms[chunk];
+                histogram.fill(0);
+                const auto end = std::min(n, (chunk + 1) * CHUNK);
+                for (auto i = chunk * CHUNK; i < end; ++i) {
+                    histogram[digit(edges[i])]++;
+                }
+            });
+
+            std::array<std::size_t, 256> totals{};
+            for (const auto& histogram : histograms) {
+                for (std::size_t d = 0; d < 256; ++d) {
+                    totals[d] += histogram[d];
+                }
+            }
+            if (std::find(totals.begin(), totals.end(), n) != totals.end()) {
+                continue;
+            }
+
+            // turn counts into per-chunk starting positions, bucket major so the sort stays stable
+            std::size_t position = 0;
+            for (std::size_t d = 0; d < 256; ++d) {
+                for (auto& histogram : histograms) {
+                    const auto count = histogram[d];
+                    histogram[d] = position;
+                    position += count;
+                }
+            }
+
+            parallel_chunks(pool, chunks, 1, [&](std::size_t chunk, std::size_t) {
+                auto& histogram = histograms[chunk];
+                const auto end = std::min(n, (chunk + 1) * CHUNK);
+                for (auto i = chunk * CHUNK; i < end; ++i) {
+                    buffer[histogram[digit(edges[i])]++] = edges[i];
+                }
+            });
+            edges.swap(buffer);
+        }
+    }
+
+    // sorts chunks in parallel and merges neighbouring runs pairwise
+    template <Vertex V, Weight W>
+    void sort_by_weight(std::vector<Edge<V, W>>& edges, ThreadPool* pool) {
+        auto less = [](const Edge<V, W>& a, const Edge<V, W>& b) {
+            return a.weight < b.weight;
+        };
+        const auto runs = pool ? pool->size() : 1;
+        const auto run_length = (edges.size() + runs - 1) / std::max<std::size_t>(runs, 1);
+        if (runs <= 1 || run_length == 0) {
+            std::stable_sort(edges.begin(), edges.end(), less);
+            return;
+        }
+
+        auto bound = [&](std::size_t run) {
+            return edges.begin() + std::min(edges.size(), run * run_length);
+        };
+        parallel_chunks(pool, runs, 1, [&](std::size_t run, std::size_t) {
+            std::stable_sort(bound(run), bound(run + 1), less);
+        });
+        for (std::size_t width = 1; width < runs; width *= 2) {
+            const auto merges = (runs + 2 * width - 1) / (2 * width);
+            parallel_chunks(pool, merges, 1, [&](std::size_t merge, std::size_t) {
+                const auto first = merge * 2 * width;
+                std::inplace_merge(bound(first), bound(std::min(runs, first + width)), bound(std::min(runs, first + 2 * width)), less);
+            });
+        }
+    }
+}
+
+// kruskal over an edge list, edge direction is ignored, the edges are sorted by weight in parallel
+// (radix sort for integral weights) and joined with a union-find
+template <Vertex V, Weight W>
+std::vector<Edge<V, W>> minimum_spanning_forest(std::vector<Edge<V, W>> edges, ThreadPool* pool = nullptr) {
+    mst_detail::sort_by_weight(edges, pool);
+
+    std::unordered_map<V, std::size_t> ids;
+    ids.reserve(edges.size());
+    auto id_of = [&](const V& vtx) {
+        return ids.try_emplace(vtx, ids.size()).first->second;
+    };
+    for (const auto& edge : edges) {
+        id_of(edge.from);
+        id_of(edge.to);
+    }
+
+    DisjointSets sets(ids.size());
+    std::vector<Edge<V, W>> forest;
+    for (const auto& edge : edges) {
+        if (forest.size() + 1 == ids.size()) {
+            break;
+        }
+        if (sets.unite(ids[edge.from], ids[edge.to])) {
+            forest.push_back(edge);
+        }
+    }
+    return forest;
+}
+
+template <Vertex V, Weight W>
+std::vector<Edge<V, W>> minimum_spanning_forest(const Graph<V, W>& graph, ThreadPool* pool = nullptr) {
+    return minimum_spanning_forest(graph.get_edges(), pool);
+}
+
+// parallel boruvka over a CsrGraph, edge direction is ignored. every round each component picks its
+// lightest incident edge (ties broken by edge index, so the picks never close a cycle) with a CAS
+// loop, then the picks are merged and component labels are refreshed from the union-find
+template <Vertex V, Weight W>
+std::vector<Edge<V, W>> boruvka_minimum_spanning_forest(const CsrGraph<V, W>& graph, ThreadPool* pool = nullptr) {
+    constexpr std::size_t CHUNK = 256;
+    constexpr auto NONE = std::numeric_limits<std::size_t>::max();
+
+    const auto n = graph.size();
+    const auto& offsets = graph.row_offsets();
+    const auto& targets = graph.column_targets();
+    const auto& weights = graph.edge_weights();
+    const auto chunks = (static_cast<std::size_t>(n) + CHUNK - 1) / CHUNK;
+
+    std::vector<std::uint32_t> component(n);
+    std::iota(component.begin(), component.end(), 0);
+    std::vector<std::size_t> best(n, NONE);
+    std::vector<std::uint32_t> source(targets.size());
+    for (std::uint32_t u = 0; u < n; ++u) {
+        std::fill(source.begin() + offsets[u], source.begin() + offsets[u + 1], u);
+    }
+
+    auto lighter = [&](std::size_t a, std::size_t b) {
+        return weights[a] < weights[b] || (!(weights[b] < weights[a]) && a < b);
+    };
+    auto offer = [&](std::uint32_t c, std::size_t edge) {
+        std::atomic_ref<std::size_t> slot(best[c]);
+        auto current = slot.load(std::memory_order_relaxed);
+        while ((current == NONE || lighter(edge, current))
+            && !slot.compare_exchange_weak(current, edge, std::memory_order_relaxed)) {
+        }
+    };
+
+    std::vector<Edge<V, W>> forest;
+    DisjointSets sets(n);
+    while (true) {
+        parallel_chunks(pool, chunks, 1, [&](std::size_t chunk, std::size_t) {
+            const auto end = std::min<std::size_t>(n, (chunk + 1) * CHUNK);
+            for (auto u = chunk * CHUNK; u < end; ++u) {
+                const auto cu = component[u];
+                for (auto i = offsets[u]; i < offsets[u + 1]; ++i) {
+                    const auto cv = component[targets[i]];
+                    if (cu != cv) {
+                        offer(cu, i);
+                        offer(cv, i);
+                    }
+                }
+            }
+        });
+
+        bool merged = false;
+        for (std::uint32_t c = 0; c < n; ++c) {
+            const auto edge = best[c];
+            if (edge == NONE) {
+                continue;
+            }
+            best[c] = NONE;
+            if (sets.unite(source[edge], targets[edge])) {
+                forest.push_back({graph.label(source[edge]), graph.label(targets[edge]), weights[edge]});
+                merged = true;
+            }
+        }
+        if (!merged) {
+            break;
+        }
+
+        parallel_chunks(pool, chunks, 1, [&](std::size_t chunk, std::size_t) {
+            const auto end = std::min<std::size_t>(n, (chunk + 1) * CHUNK);
+            for (auto u = chunk * CHUNK; u < end; ++u) {
+                component[u] = static_cast<std::uint32_t>(sets.find_root(u));
+            }
+        });
+    }
+    return forest;
+}
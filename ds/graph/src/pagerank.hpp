@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "csr.hpp"
+#include "thread_pool.hpp"
+
+struct PageRankOptions {
+    double damping = 0.85;
+    double tolerance = 1e-6;           // on the l1 change of the rank vector
+    std::size_t max_iterations = 100;
+    std::size_t check_every = 1;       // convergence is only measured every k-th iteration
+};
+
+struct PageRankResult {
+    std::vector<double> ranks;         // indexed by dense id of the source graph
+    std::size_t iterations = 0;
+    double residual = 0.0;
+};
+
+// pull based sparse matrix-vector engine over the in-edge CSR of a graph: every vertex reads its
+// in-neighbors and writes only its own entry, so no atomics are needed. vertex ranges are split
+// once into one part per worker with roughly the same number of in-edges
+template <Vertex V, Weight W>
+class PullEngine {
+    const CsrGraph<V, W>& graph;
+    CsrGraph<V, W> in_edges;
+    ThreadPool& pool;
+    std::vector<std::uint32_t> bounds; // part p covers [bounds[p], bounds[p + 1])
+
+public:
+    PullEngine(const CsrGraph<V, W>& graph, ThreadPool& pool)
+        : graph(graph),
+          in_edges(graph.transpose()),
+          pool(pool)
+    {
+        // balance on in-edges + vertices, so parts of isolated vertices are not empty work
+        const auto n = graph.size();
+        const auto& offsets = in_edges.row_offsets();
+        const auto parts = std::max<std::size_t>(1, std::min<std::size_t>(pool.size(), n));
+        const auto total = offsets.back() + n;
+        bounds.assign(1, 0);
+        for (std::size_t p = 1; p < parts; ++p) {
+            const auto goal = total * p / parts;
+            std::uint32_t lo = bounds.back(), hi = n;
+            while (lo < hi) {
+                const auto mid = lo + (hi - lo) / 2;
+                if (offsets[mid] + mid < goal) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            bounds.push_back(lo);
+        }
+        bounds.push_back(n);
+    }
+
+    std::size_t parts() const {
+        return bounds.size() - 1;
+    }
+
+    // y[v] = fn(v, in-neighbors of v, their edge weights) for every v, fn must only read shared state
+    template <typename T, typename F>
+    void pull(std::vector<T>& y, F&& fn) const {
+        y.resize(graph.size());
+        pool.parallel_for(parts(), [&](std::size_t part, std::size_t) {
+            for (auto v = bounds[part]; v < bounds[part + 1]; ++v) {
+                y[v] = fn(v, in_edges.neighbors(v), in_edges.neighbor_weights(v));
+            }
+        });
+    }
+
+    // y = A^T x with A the weighted adjacency matrix, i.e. y[v] = sum of w(u, v) * x[u]
+    template <typename T>
+    void multiply(const std::vector<T>& x, std::vector<T>& y) const {
+        pull(y, [&](std::uint32_t, std::span<const std::uint32_t> sources, std::span<const W> weights) {
+            T sum{};
+            for (std::size_t i = 0; i < sources.size(); ++i) {
+                sum += static_cast<T>(weights[i]) * x[sources[i]];
+            }
+            return sum;
+        });
+    }
+
+    // weights are ignored, dangling vertices spread their rank uniformly
+    PageRankResult pagerank(const PageRankOptions& options = {}) const {
+        const auto n = graph.size();
+        PageRankResult result;
+        if (n == 0) {
+            return result;
+        }
+
+        const auto base = (1.0 - options.damping) / n;
+        std::vector<double> rank(n, 1.0 / n), next(n), contribution(n);
+        std::vector<double> dangling(parts()), change(parts());
+
+        for (std::size_t iteration = 1; iteration <= options.max_iterations; ++iteration) {
+            pool.parallel_for(parts(), [&](std::size_t part, std::size_t) {
+                double lost = 0.0;
+                for (auto u = bounds[part]; u < bounds[part + 1]; ++u) {
+                    const auto degree = graph.degree(u);
+                    contribution[u] = degree == 0 ? 0.0 : rank[u] / degree;
+                    lost += degree == 0 ? rank[u] : 0.0;
+                }
+                dangling[part] = lost;
+            });
+
+            double dangling_sum = 0.0;
+            for (const auto lost : dangling) {
+                dangling_sum += lost;
+            }
+            const auto teleport = base + options.damping * dangling_sum / n;
+            const bool check = iteration % std::max<std::size_t>(options.check_every, 1) == 0
+                || iteration == options.max_iterations;
+
+            pool.parallel_for(parts(), [&](std::size_t part, std::size_t) {
+                double delta = 0.0;
+                for (auto v = bounds[part]; v < bounds[part + 1]; ++v) {
+                    double sum = 0.0;
+                    for (const auto u : in_edges.neighbors(v)) {
+                        sum += contribution[u];
+                    }
+                    next[v] = teleport + options.damping * sum;
+                    if (check) {
+                        delta += std::abs(next[v] - rank[v]);
+                    }
+                }
+                change[part] = delta;
+            });
+
+            rank.swap(next);
+            result.iterations = iteration;
+            if (check) {
+                result.residual = 0.0;
+                for (const auto delta : change) {
+                    result.residual += delta;
+                }
+                if (result.residual < options.tolerance) {
+                    break;
+                }
+            }
+        }
+
+        result.ranks = std::move(rank);
+        return result;
+    }
+};
+
+template <Vertex V, Weight W>
+PageRankResult pagerank(const CsrGraph<V, W>& graph, ThreadPool& pool, const PageRankOptions& options = {}) {
+    return PullEngine<V, W>(graph, pool).pagerank(options);
+}
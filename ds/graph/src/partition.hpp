@@ -0,0 +1,536 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "csr.hpp"
+#include "thread_pool.hpp"
+
+struct PartitionOptions {
+    double imbalance = 0.03;               // a part may hold (1 + imbalance) * n / k vertices
+    std::size_t coarsening_rounds = 3;     // label propagation sweeps before every contraction
+    std::size_t refinement_rounds = 6;     // label propagation sweeps on every level going back up
+    std::size_t coarsest_per_part = 64;    // coarsening stops below k times this many vertices
+    std::uint64_t seed = 280131;           // for the visiting order
+};
+
+struct PartitionResult {
+    std::vector<std::uint32_t> parts;      // part in [0, k) per dense id
+    std::vector<std::size_t> part_sizes;
+    std::size_t edge_cut = 0;              // input edges whose endpoints are in different parts
+    double balance = 0.0;                  // largest part over n / k
+};
+
+// one shard of a partitioned CsrGraph: the part's vertices get local ids [0, owned) in increasing
+// global id, followed by the ghosts, the other parts' vertices its edges point at. every edge is
+// kept in the shard of its source, ghost rows are empty
+template <Vertex V, Weight W>
+struct PartitionSubgraph {
+    CsrGraph<V, W> graph;
+    std::uint32_t owned = 0;
+    std::vector<std::uint32_t> global_ids;  // dense id in the partitioned graph per local id
+    std::vector<std::uint32_t> ghost_parts; // owning part of ghost `owned + i`
+};
+
+namespace partition_detail {
+    constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+    constexpr std::size_t CHUNK = 256;
+    // contraction stops when a level keeps more than this share of the vertices
+    constexpr double MIN_SHRINK = 0.95;
+
+    inline std::uint32_t load(std::vector<std::uint32_t>& values, std::size_t i) {
+        return std::atomic_ref<std::uint32_t>(values[i]).load(std::memory_order_relaxed);
+    }
+
+    // undirected graph of one level: edge weights count the input edges between two vertices in
+    // either direction, vertex weights count the input vertices merged into one
+    struct Level {
+        std::vector<std::size_t> offsets{0};
+        std::vector<std::uint32_t> targets;
+        std::vector<std::uint64_t> weights;
+        std::vector<std::uint64_t> vertex_weights;
+        std::uint64_t total_weight = 0;
+
+        std::uint32_t size() const {
+            return static_cast<std::uint32_t>(vertex_weights.size());
+        }
+    };
+
+    // connection weight to every label seen around one vertex, reset through `touched`
+    struct Scratch {
+        std::vector<std::uint64_t> connection;
+        std::vector<std::uint32_t> touched;
+
+        template <typename F>
+        void gather(const Level& level, std::uint32_t u, F&& label_of) {
+            for (auto i = level.offsets[u]; i < level.offsets[u + 1]; ++i) {
+                const auto label = label_of(level.targets[i]);
+                if (connection[label] == 0) {
+                    touched.push_back(label);
+                }
+                connection[label] += level.weights[i];
+            }
+        }
+
+        void clear() {
+            for (const auto label : touched) {
+                connection[label] = 0;
+            }
+            touched.clear();
+        }
+    };
+
+    inline std::vector<Scratch> make_scratch(std::size_t slots, std::size_t labels) {
+        std::vector<Scratch> scratch(slots);
+        for (auto& s : scratch) {
+            s.connection.assign(labels, 0);
+        }
+        return scratch;
+    }
+
+    // fills a level from per-vertex rows produced by `row(u, scratch, emit(target, weight))`, once
+    // to count and once to write, both passes in parallel
+    template <typename Row>
+    void fill_rows(Level& level, std::uint32_t n, std::vector<Scratch>& scratch, ThreadPool* pool, Row&& row) {
+        level.offsets.assign(n + 1, 0);
+        parallel_chunks(pool, n, CHUNK, [&](std::size_t u, std::size_t slot) {
+            std::size_t count = 0;
+            row(static_cast<std::uint32_t>(u), scratch[slot], [&](std::uint32_t, std::uint64_t) {
+                ++count;
+            });
+            level.offsets[u + 1] = count;
+        });
+        std::partial_sum(level.offsets.begin(), level.offsets.end(), level.offsets.begin());
+        level.targets.resize(level.offsets.back());
+        level.weights.resize(level.offsets.back());
+        parallel_chunks(pool, n, CHUNK, [&](std::size_t u, std::size_t slot) {
+            auto at = level.offsets[u];
+            row(static_cast<std::uint32_t>(u), scratch[slot], [&](std::uint32_t target, std::uint64_t weight) {
+                level.targets[at] = target;
+                level.weights[at] = weight;
+                ++at;
+            });
+        });
+    }
+
+    // symmetric view of the input, parallel edges add up and self-loops are dropped
+    template <Vertex V, Weight W>
+    Level finest_level(const CsrGraph<V, W>& graph, ThreadPool* pool) {
+        const auto n = graph.size();
+        const auto in_edges = graph.transpose();
+        Level level;
+        level.vertex_weights.assign(n, 1);
+        level.total_weight = n;
+        auto scratch = make_scratch(pool ? pool->size() : 1, 0);
+        // both rows are sorted, so equal targets are adjacent in the merge
+        fill_rows(level, n, scratch, pool, [&](std::uint32_t u, Scratch&, auto&& emit) {
+            const auto out = graph.neighbors(u);
+            const auto in = in_edges.neighbors(u);
+            std::size_t i = 0, j = 0;
+            std::uint32_t last = NONE;
+            std::uint64_t weight = 0;
+            while (i < out.size() || j < in.size()) {
+                const auto v = j == in.size() || (i < out.size() && out[i] <= in[j]) ? out[i++] : in[j++];
+                if (v == u) {
+                    continue;
+                }
+                if (v != last && last != NONE) {
+                    emit(last, weight);
+                    weight = 0;
+                }
+                last = v;
+                ++weight;
+            }
+            if (last != NONE) {
+                emit(last, weight);
+            }
+        });
+        return level;
+    }
+
+    // label propagation sweeps: every vertex joins the label it is most strongly connected to when
+    // that label's weight stays within `limit`, ties go to the lighter label. labels and their
+    // weights are shared between workers through relaxed atomics, a move first reserves room in
+    // the target label with a CAS so the limit holds under concurrency
+    inline void propagate(
+        const Level& level,
+        std::vector<std::uint32_t>& labels,
+        std::vector<std::uint64_t>& label_weights,
+        std::uint64_t limit,
+        const std::vector<std::uint32_t>& order,
+        std::size_t rounds,
+        std::vector<Scratch>& scratch,
+        ThreadPool* pool
+    ) {
+        for (std::size_t round = 0; round < rounds; ++round) {
+            std::atomic<std::size_t> moves{0};
+            parallel_chunks(pool, order.size(), CHUNK, [&](std::size_t i, std::size_t slot) {
+                const auto u = order[i];
+                const auto own = load(labels, u);
+                const auto weight = level.vertex_weights[u];
+                auto& s = scratch[slot];
+                s.gather(level, u, [&](std::uint32_t v) {
+                    return load(labels, v);
+                });
+
+                auto best = own;
+                auto best_connection = s.connection[own];
+                auto best_weight = std::numeric_limits<std::uint64_t>::max();
+                for (const auto label : s.touched) {
+                    if (label == own) {
+                        continue;
+                    }
+                    const auto connection = s.connection[label];
+                    const auto label_weight = std::atomic_ref<std::uint64_t>(label_weights[label]).load(std::memory_order_relaxed);
+                    if (label_weight + weight > limit) {
+                        continue;
+                    }
+                    if (connection > best_connection || (connection == best_connection && best != own && label_weight < best_weight)) {
+                        best = label;
+                        best_connection = connection;
+                        best_weight = label_weight;
+                    }
+                }
+                s.clear();
+                if (best == own) {
+                    return;
+                }
+
+                std::atomic_ref<std::uint64_t> target(label_weights[best]);
+                auto current = target.load(std::memory_order_relaxed);
+                do {
+                    if (current + weight > limit) {
+                        return;
+                    }
+                } while (!target.compare_exchange_weak(current, current + weight, std::memory_order_relaxed));
+                std::atomic_ref<std::uint64_t>(label_weights[own]).fetch_sub(weight, std::memory_order_relaxed);
+                std::atomic_ref<std::uint32_t>(labels[u]).store(best, std::memory_order_relaxed);
+                moves.fetch_add(1, std::memory_order_relaxed);
+            });
+            if (moves.load() == 0) {
+                break;
+            }
+        }
+    }
+
+    // merges every cluster into one vertex, `clusters` is rewritten to the dense coarse ids
+    inline Level contract(const Level& fine, std::vector<std::uint32_t>& clusters, std::vector<Scratch>& scratch, ThreadPool* pool) {
+        const auto n = fine.size();
+        std::vector<std::uint32_t> coarse_id(n, NONE);
+        std::uint32_t coarse_n = 0;
+        for (std::uint32_t u = 0; u < n; ++u) {
+            if (coarse_id[clusters[u]] == NONE) {
+                coarse_id[clusters[u]] = coarse_n++;
+            }
+        }
+
+        Level coarse;
+        coarse.vertex_weights.assign(coarse_n, 0);
+        coarse.total_weight = fine.total_weight;
+        std::vector<std::size_t> member_offsets(coarse_n + 1, 0);
+        for (std::uint32_t u = 0; u < n; ++u) {
+            clusters[u] = coarse_id[clusters[u]];
+            coarse.vertex_weights[clusters[u]] += fine.vertex_weights[u];
+            member_offsets[clusters[u] + 1]++;
+        }
+        std::partial_sum(member_offsets.begin(), member_offsets.end(), member_offsets.begin());
+        std::vector<std::uint32_t> members(n);
+        auto fill = member_offsets;
+        for (std::uint32_t u = 0; u < n; ++u) {
+            members[fill[clusters[u]]++] = u;
+        }
+
+        for (auto& s : scratch) {
+            s.connection.assign(coarse_n, 0);
+        }
+        fill_rows(coarse, coarse_n, scratch, pool, [&](std::uint32_t c, Scratch& s, auto&& emit) {
+            for (auto m = member_offsets[c]; m < member_offsets[c + 1]; ++m) {
+                s.gather(fine, members[m], [&](std::uint32_t v) {
+                    return clusters[v];
+                });
+            }
+            std::sort(s.touched.begin(), s.touched.end());
+            for (const auto target : s.touched) {
+                if (target != c) {
+                    emit(target, s.connection[target]);
+                }
+            }
+            s.clear();
+        });
+        return coarse;
+    }
+
+    inline std::vector<std::uint32_t> visiting_order(std::uint32_t n, std::uint64_t seed) {
+        std::vector<std::uint32_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::mt19937_64 gen(seed);
+        std::shuffle(order.begin(), order.end(), gen);
+        return order;
+    }
+
+    // graph growing on the coarsest level: a bfs order (restarted per component) keeps neighbors
+    // together and is cut into k consecutive runs of equal weight
+    inline std::vector<std::uint32_t> initial_parts(const Level& level, std::uint32_t k) {
+        const auto n = level.size();
+        std::vector<std::uint32_t> order;
+        order.reserve(n);
+        std::vector<bool> seen(n, false);
+        for (std::uint32_t root = 0; root < n; ++root) {
+            if (seen[root]) {
+                continue;
+            }
+            seen[root] = true;
+            order.push_back(root);
+            for (auto head = order.size() - 1; head < order.size(); ++head) {
+                const auto u = order[head];
+                for (auto i = level.offsets[u]; i < level.offsets[u + 1]; ++i) {
+                    if (!seen[level.targets[i]]) {
+                        seen[level.targets[i]] = true;
+                        order.push_back(level.targets[i]);
+                    }
+                }
+            }
+        }
+
+        std::vector<std::uint32_t> parts(n);
+        std::uint64_t before = 0;
+        for (const auto u : order) {
+            // the part is chosen by the middle of the vertex's weight range
+            const auto middle = before + level.vertex_weights[u] / 2;
+            parts[u] = static_cast<std::uint32_t>(std::min<std::uint64_t>(k - 1, middle * k / level.total_weight));
+            before += level.vertex_weights[u];
+        }
+        return parts;
+    }
+
+    // sequential sweep over overloaded parts, every vertex of one moves to the best connected part
+    // with room, or to the lightest part, until its part fits the limit
+    inline void rebalance(
+        const Level& level,
+        std::vector<std::uint32_t>& parts,
+        std::vector<std::uint64_t>& part_weights,
+        std::uint64_t limit,
+        const std::vector<std::uint32_t>& order,
+        Scratch& s
+    ) {
+        if (*std::max_element(part_weights.begin(), part_weights.end()) <= limit) {
+            return;
+        }
+        for (const auto u : order) {
+            const auto own = parts[u];
+            const auto weight = level.vertex_weights[u];
+            if (part_weights[own] <= limit) {
+                continue;
+            }
+            s.gather(level, u, [&](std::uint32_t v) {
+                return parts[v];
+            });
+            auto best = NONE;
+            for (const auto label : s.touched) {
+                if (label != own && part_weights[label] + weight <= limit
+                    && (best == NONE || s.connection[label] > s.connection[best])) {
+                    best = label;
+                }
+            }
+            s.clear();
+            if (best == NONE) {
+                best = static_cast<std::uint32_t>(std::min_element(part_weights.begin(), part_weights.end()) - part_weights.begin());
+                if (best == own || part_weights[best] + weight > limit) {
+                    continue;
+                }
+            }
+            part_weights[own] -= weight;
+            part_weights[best] += weight;
+            parts[u] = best;
+        }
+    }
+}
+
+// multilevel k-way partitioning of the undirected view of `graph` (direction is ignored, parallel
+// edges weigh more). coarsening runs size constrained label propagation and contracts the
+// clusters until about k * coarsest_per_part vertices are left, the coarsest graph is split by
+// graph growing, then every level going back up refines the projected parts with balance
+// constrained label propagation. a final rebalancing sweep enforces the imbalance bound. with a
+// pool the sweeps run in parallel and the result depends on the schedule
+template <Vertex V, Weight W>
+PartitionResult partition(const CsrGraph<V, W>& graph, std::uint32_t k, ThreadPool* pool = nullptr, const PartitionOptions& options = {}) {
+    using namespace partition_detail;
+    if (k == 0) {
+        throw std::invalid_argument("partition requires at least one part");
+    }
+    const auto n = graph.size();
+    const auto slots = pool ? pool->size() : 1;
+
+    std::vector<Level> levels;
+    levels.push_back(finest_level(graph, pool));
+    std::vector<std::vector<std::uint32_t>> clusters;  // clusters[l] maps level l to level l + 1
+
+    const auto part_limit = std::max<std::uint64_t>(
+        (n + k - 1) / k,
+        static_cast<std::uint64_t>(std::floor((1.0 + options.imbalance) * n / k))
+    );
+    const auto coarsest = std::max<std::size_t>(1, static_cast<std::size_t>(k) * options.coarsest_per_part);
+    // clusters stay small enough that the coarsest level can still be balanced
+    const auto cluster_limit = std::max<std::uint64_t>(1, std::min<std::uint64_t>(part_limit, n / coarsest));
+
+    std::uint64_t seed = options.seed;
+    while (levels.back().size() > coarsest) {
+        const auto& fine = levels.back();
+        auto scratch = make_scratch(slots, fine.size());
+        std::vector<std::uint32_t> labels(fine.size());
+        std::iota(labels.begin(), labels.end(), 0);
+        auto label_weights = fine.vertex_weights;
+        propagate(fine, labels, label_weights, cluster_limit, visiting_order(fine.size(), seed++), options.coarsening_rounds, scratch, pool);
+
+        auto coarse = contract(fine, labels, scratch, pool);
+        if (coarse.size() > MIN_SHRINK * fine.size()) {
+            break;
+        }
+        clusters.push_back(std::move(labels));
+        levels.push_back(std::move(coarse));
+    }
+
+    auto parts = initial_parts(levels.back(), k);
+    for (auto l = levels.size(); l-- > 0;) {
+        const auto& level = levels[l];
+        if (l + 1 < levels.size()) {
+            std::vector<std::uint32_t> projected(level.size());
+            for (std::uint32_t u = 0; u < level.size(); ++u) {
+                projected[u] = parts[clusters[l][u]];
+            }
+            parts = std::move(projected);
+        }
+        std::vector<std::uint64_t> part_weights(k, 0);
+        for (std::uint32_t u = 0; u < level.size(); ++u) {
+            part_weights[parts[u]] += level.vertex_weights[u];
+        }
+        auto scratch = make_scratch(slots, k);
+        const auto order = visiting_order(level.size(), seed++);
+        propagate(level, parts, part_weights, part_limit, order, options.refinement_rounds, scratch, pool);
+        rebalance(level, parts, part_weights, part_limit, order, scratch[0]);
+    }
+
+    PartitionResult result;
+    result.parts = std::move(parts);
+    result.part_sizes.assign(k, 0);
+    for (const auto part : result.parts) {
+        result.part_sizes[part]++;
+    }
+    std::vector<std::size_t> cuts(slots, 0);
+    parallel_chunks(pool, n, CHUNK, [&](std::size_t u, std::size_t slot) {
+        for (const auto v : graph.neighbors(static_cast<std::uint32_t>(u))) {
+            cuts[slot] += result.parts[u] != result.parts[v];
+        }
+    });
+    for (const auto cut : cuts) {
+        result.edge_cut += cut;
+    }
+    if (n > 0) {
+        result.balance = static_cast<double>(*std::max_element(result.part_sizes.begin(), result.part_sizes.end())) * k / n;
+    }
+    return result;
+}
+
+// one subgraph per part, built in parallel over the parts
+template <Vertex V, Weight W>
+std::vector<PartitionSubgraph<V, W>> partition_subgraphs(
+    const CsrGraph<V, W>& graph,
+    const std::vector<std::uint32_t>& parts,
+    std::uint32_t k,
+    ThreadPool* pool = nullptr
+) {
+    using partition_detail::NONE;
+    const auto n = graph.size();
+    if (parts.size() != n) {
+        throw std::invalid_argument("partition vector does not match the graph");
+    }
+
+    std::vector<std::size_t> member_offsets(k + 1, 0);
+    for (const auto part : parts) {
+        if (part >= k) {
+            throw std::invalid_argument("partition vector names a part outside [0, k)");
+        }
+        member_offsets[part + 1]++;
+    }
+    std::partial_sum(member_offsets.begin(), member_offsets.end(), member_offsets.begin());
+    std::vector<std::uint32_t> members(n);
+    auto fill = member_offsets;
+    for (std::uint32_t u = 0; u < n; ++u) {
+        members[fill[parts[u]]++] = u;
+    }
+
+    const auto slots = pool ? pool->size() : 1;
+    std::vector<std::vector<std::uint32_t>> local_ids(slots);
+    std::vector<PartitionSubgraph<V, W>> result(k);
+    parallel_chunks(pool, k, 1, [&](std::size_t p, std::size_t slot) {
+        auto& local = local_ids[slot];
+        local.resize(n, NONE);
+        auto& shard = result[p];
+        shard.global_ids.assign(members.begin() + member_offsets[p], members.begin() + member_offsets[p + 1]);
+        shard.owned = static_cast<std::uint32_t>(shard.global_ids.size());
+        for (std::uint32_t i = 0; i < shard.owned; ++i) {
+            local[shard.global_ids[i]] = i;
+        }
+
+        std::vector<std::uint32_t> ghosts;
+        for (std::uint32_t i = 0; i < shard.owned; ++i) {
+            for (const auto v : graph.neighbors(shard.global_ids[i])) {
+                if (local[v] == NONE) {
+                    local[v] = 0;  // claimed, renumbered below
+                    ghosts.push_back(v);
+                }
+            }
+        }
+        std::sort(ghosts.begin(), ghosts.end());
+        for (const auto v : ghosts) {
+            local[v] = static_cast<std::uint32_t>(shard.global_ids.size());
+            shard.global_ids.push_back(v);
+            shard.ghost_parts.push_back(parts[v]);
+        }
+
+        std::vector<V> labels;
+        labels.reserve(shard.global_ids.size());
+        for (const auto id : shard.global_ids) {
+            labels.push_back(graph.label(id));
+        }
+        std::vector<std::size_t> offsets(shard.global_ids.size() + 1, 0);
+        std::vector<std::uint32_t> targets;
+        std::vector<W> weights;
+        std::vector<std::pair<std::uint32_t, W>> row;
+        for (std::uint32_t i = 0; i < shard.owned; ++i) {
+            const auto u = shard.global_ids[i];
+            const auto row_targets = graph.neighbors(u);
+            const auto row_weights = graph.neighbor_weights(u);
+            row.clear();
+            for (std::size_t e = 0; e < row_targets.size(); ++e) {
+                row.push_back({local[row_targets[e]], row_weights[e]});
+            }
+            // owned and ghost ids are each increasing in the global id, only the two runs interleave
+            std::stable_sort(row.begin(), row.end(), [](const auto& a, const auto& b) {
+                return a.first < b.first;
+            });
+            for (const auto& [target, weight] : row) {
+                targets.push_back(target);
+                weights.push_back(weight);
+            }
+            offsets[i + 1] = targets.size();
+        }
+        for (auto i = shard.owned; i < shard.global_ids.size(); ++i) {
+            offsets[i + 1] = targets.size();
+        }
+        shard.graph = CsrGraph<V, W>(std::move(labels), std::move(offsets), std::move(targets), std::move(weights));
+
+        for (const auto id : shard.global_ids) {
+            local[id] = NONE;
+        }
+    });
+    return result;
+}
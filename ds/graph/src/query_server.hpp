@@ -0,0 +1,63 @@
+#pragma once
+
+#include <future>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph.hpp"
+#include "thread_pool.hpp"
+
+// serves point to point dijkstra queries on a shared read-only graph. queries run on the pool and
+// every worker keeps one SearchContext, so a warm server allocates nothing per query apart from
+// the returned path. answers are those of Graph::dijkstra(start, end, context). the graph must not
+// be modified while queries are in flight
+template <Vertex V, Weight W>
+class QueryServer {
+public:
+    using Path = std::optional<std::vector<Edge<V, W>>>;
+
+    QueryServer(const Graph<V, W>& graph, ThreadPool& pool)
+        : graph(graph), pool(pool), contexts(pool.size()) {}
+
+    // answers in query order, blocks until the whole batch is done
+    std::vector<Path> dijkstra_batch(std::span<const std::pair<V, V>> queries) {
+        std::vector<Path> paths(queries.size());
+        pool.parallel_for(queries.size(), [&](std::size_t i, std::size_t) {
+            paths[i] = query(queries[i].first, queries[i].second);
+        });
+        return paths;
+    }
+
+    std::future<Path> submit(const V& start, const V& end) {
+        return pool.submit([this, start, end] {
+            return query(start, end);
+        });
+    }
+
+private:
+    const Graph<V, W>& graph;
+    ThreadPool& pool;
+    std::vector<SearchContext<V, W>> contexts;
+
+    // only ever called from a pool task, which never waits, so the worker owns its context
+    Path query(const V& start, const V& end) {
+        return graph.dijkstra(start, end, contexts[pool.current_worker()]);
+    }
+};
+
+// one-off batch on a pool of `threads` workers, a QueryServer amortizes the pool and workspaces
+// over many batches. V and W come from the graph alone, so any contiguous range of pairs converts
+template <Vertex V, Weight W>
+std::vector<std::optional<std::vector<Edge<V, W>>>> dijkstra_batch(
+    const Graph<V, W>& graph,
+    std::type_identity_t<std::span<const std::pair<V, V>>> queries,
+    std::size_t threads = std::thread::hardware_concurrency()
+) {
+    ThreadPool pool(threads);
+    QueryServer<V, W> server(graph, pool);
+    return server.dijkstra_batch(queries);
+}
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "csr.hpp"
+#include "thread_pool.hpp"
+
+enum class ReorderStrategy {
+    ReverseCuthillMcKee,    // bandwidth reduction over the undirected view
+    DegreeSort,             // decreasing in + out degree
+    HubCluster,             // above average degree vertices first, both groups keep their order
+    Gorder,                 // greedy window placement of vertices sharing in-neighbors (wei et al.)
+};
+
+namespace reorder_detail {
+    constexpr std::size_t CHUNK = 1024;
+    constexpr std::size_t GORDER_WINDOW = 5;
+    constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+    template <Vertex V, Weight W>
+    std::vector<std::size_t> total_degrees(const CsrGraph<V, W>& graph, const CsrGraph<V, W>& in_edges) {
+        std::vector<std::size_t> degree(graph.size());
+        for (std::uint32_t u = 0; u < graph.size(); ++u) {
+            degree[u] = graph.degree(u) + in_edges.degree(u);
+        }
+        return degree;
+    }
+
+    // order[i] is the old id placed at position i, cuthill-mckee bfs over out- and in-edges with
+    // neighbours taken by increasing degree, every component starts at its lowest degree vertex
+    template <Vertex V, Weight W>
+    std::vector<std::uint32_t> reverse_cuthill_mckee(const CsrGraph<V, W>& graph, const CsrGraph<V, W>& in_edges) {
+        const auto n = graph.size();
+        const auto degree = total_degrees(graph, in_edges);
+        std::vector<std::uint32_t> by_degree(n);
+        std::iota(by_degree.begin(), by_degree.end(), 0);
+        std::stable_sort(by_degree.begin(), by_degree.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return degree[a] < degree[b];
+        });
+
+        std::vector<std::uint32_t> order;
+        order.reserve(n);
+        std::vector<bool> placed(n, false);
+        std::vector<std::uint32_t> level;
+        for (const auto start : by_degree) {
+            if (placed[start]) {
+                continue;
+            }
+            placed[start] = true;
+            order.push_back(start);
+            for (auto head = order.size() - 1; head < order.size(); ++head) {
+                const auto u = order[head];
+                level.clear();
+                for (const auto* side : {&graph, &in_edges}) {
+                    for (const auto v : side->neighbors(u)) {
+                        if (!placed[v]) {
+                            placed[v] = true;
+                            level.push_back(v);
+                        }
+                    }
+                }
+                std::stable_sort(level.begin(), level.end(), [&](std::uint32_t a, std::uint32_t b) {
+                    return degree[a] < degree[b];
+                });
+                order.insert(order.end(), level.begin(), level.end());
+            }
+        }
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
+    template <Vertex V, Weight W>
+    std::vector<std::uint32_t> degree_sort(const CsrGraph<V, W>& graph, const CsrGraph<V, W>& in_edges) {
+        const auto degree = total_degrees(graph, in_edges);
+        std::vector<std::uint32_t> order(graph.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return degree[a] > degree[b];
+        });
+        return order;
+    }
+
+    template <Vertex V, Weight W>
+    std::vector<std::uint32_t> hub_cluster(const CsrGraph<V, W>& graph, const CsrGraph<V, W>& in_edges) {
+        const auto degree = total_degrees(graph, in_edges);
+        const auto average = graph.size() == 0 ? 0 : 2 * graph.edge_count() / graph.size();
+        std::vector<std::uint32_t> order(graph.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_partition(order.begin(), order.end(), [&](std::uint32_t u) {
+            return degree[u] > average;
+        });
+        return order;
+    }
+
+    // max-priority queue over small integer keys that only move by +-1: one doubly linked list
+    // per key and a cursor on the highest non-empty one, so every update is O(1) (the "unit heap"
+    // of the gorder paper). all vertices start in bucket 0, lowest id at the head
+    class UnitHeap {
+        std::vector<std::int64_t> key;
+        std::vector<std::uint32_t> prev, next;
+        std::vector<std::uint32_t> head;
+        std::vector<bool> removed;
+        std::size_t top = 0;
+
+        void unlink(std::uint32_t v) {
+            if (prev[v] != NONE) {
+                next[prev[v]] = next[v];
+            } else {
+                head[key[v]] = next[v];
+            }
+            if (next[v] != NONE) {
+                prev[next[v]] = prev[v];
+            }
+        }
+
+        void link(std::uint32_t v) {
+            const auto k = static_cast<std::size_t>(key[v]);
+            if (k >= head.size()) {
+                head.resize(k + 1, NONE);
+            }
+            prev[v] = NONE;
+            next[v] = head[k];
+            if (head[k] != NONE) {
+                prev[head[k]] = v;
+            }
+            head[k] = v;
+            top = std::max(top, k);
+        }
+
+    public:
+        explicit UnitHeap(std::uint32_t n)
+            : key(n, 0),
+              prev(n, NONE),
+              next(n, NONE),
+              head(1, NONE),
+              removed(n, false)
+        {
+            for (auto v = n; v-- > 0;) {
+                link(v);
+            }
+        }
+
+        void add(std::uint32_t v, std::int64_t delta) {
+            if (removed[v]) {
+                return;
+            }
+            unlink(v);
+            key[v] += delta;
+            link(v);
+        }
+
+        std::uint32_t pop() {
+            while (top > 0 && head[top] == NONE) {
+                --top;
+            }
+            const auto v = head[top];
+            unlink(v);
+            removed[v] = true;
+            return v;
+        }
+
+        void remove(std::uint32_t v) {
+            unlink(v);
+            removed[v] = true;
+        }
+    };
+
+    // every vertex keeps a score against the last GORDER_WINDOW placed vertices: +1 per edge to
+    // one of them and +1 per in-neighbor shared with one of them, the next vertex is the unplaced
+    // one with the highest score. in-neighbors with more than sqrt(n) out-edges are skipped as
+    // siblings, they relate everything to everything and would make each step quadratic
+    template <Vertex V, Weight W>
+    std::vector<std::uint32_t> gorder(const CsrGraph<V, W>& graph, const CsrGraph<V, W>& in_edges) {
+        const auto n = graph.size();
+        std::vector<std::uint32_t> order;
+        order.reserve(n);
+        if (n == 0) {
+            return order;
+        }
+
+        const auto hub_degree = static_cast<std::size_t>(std::sqrt(static_cast<double>(n))) + 1;
+        UnitHeap heap(n);
+        auto update = [&](std::uint32_t u, std::int64_t delta) {
+            for (const auto v : graph.neighbors(u)) {
+                heap.add(v, delta);
+            }
+            for (const auto p : in_edges.neighbors(u)) {
+                heap.add(p, delta);
+                if (graph.degree(p) <= hub_degree) {
+                    for (const auto v : graph.neighbors(p)) {
+                        heap.add(v, delta);
+                    }
+                }
+            }
+        };
+
+        // seed with the vertex of highest in-degree
+        std::uint32_t next = 0;
+        for (std::uint32_t u = 1; u < n; ++u) {
+            if (in_edges.degree(u) > in_edges.degree(next)) {
+                next = u;
+            }
+        }
+        heap.remove(next);
+        while (true) {
+            order.push_back(next);
+            update(next, 1);
+            if (order.size() > GORDER_WINDOW) {
+                update(order[order.size() - 1 - GORDER_WINDOW], -1);
+            }
+            if (order.size() == n) {
+                break;
+            }
+            next = heap.pop();
+        }
+        return order;
+    }
+}
+
+// new dense id of every old dense id for the given strategy
+template <Vertex V, Weight W>
+std::vector<std::uint32_t> vertex_order(const CsrGraph<V, W>& graph, ReorderStrategy strategy) {
+    using namespace reorder_detail;
+    const auto in_edges = graph.transpose();
+    std::vector<std::uint32_t> order;
+    switch (strategy) {
+    case ReorderStrategy::ReverseCuthillMcKee:
+        order = reverse_cuthill_mckee(graph, in_edges);
+        break;
+    case ReorderStrategy::DegreeSort:
+        order = degree_sort(graph, in_edges);
+        break;
+    case ReorderStrategy::HubCluster:
+        order = hub_cluster(graph, in_edges);
+        break;
+    case ReorderStrategy::Gorder:
+        order = gorder(graph, in_edges);
+        break;
+    }
+
+    std::vector<std::uint32_t> new_id(order.size());
+    for (std::uint32_t position = 0; position < order.size(); ++position) {
+        new_id[order[position]] = position;
+    }
+    return new_id;
+}
+
+// rebuilds `graph` with vertex u moved to dense id new_id[u], labels travel with their vertex so
+// every label based query answers the same as before
+template <Vertex V, Weight W>
+CsrGraph<V, W> permute(const CsrGraph<V, W>& graph, const std::vector<std::uint32_t>& new_id, ThreadPool* pool = nullptr) {
+    const auto n = graph.size();
+    if (new_id.size() != n) {
+        throw std::invalid_argument("Permutation does not match the graph");
+    }
+    std::vector<std::uint32_t> old_id(n, reorder_detail::NONE);
+    for (std::uint32_t u = 0; u < n; ++u) {
+        if (new_id[u] >= n || old_id[new_id[u]] != reorder_detail::NONE) {
+            throw std::invalid_argument("Not a permutation");
+        }
+        old_id[new_id[u]] = u;
+    }
+
+    std::vector<V> labels(n);
+    std::vector<std::size_t> offsets(n + 1, 0);
+    for (std::uint32_t v = 0; v < n; ++v) {
+        labels[v] = graph.label(old_id[v]);
+        offsets[v + 1] = offsets[v] + graph.degree(old_id[v]);
+    }
+
+    std::vector<std::uint32_t> targets(graph.edge_count());
+    std::vector<W> weights(graph.edge_count());
+    parallel_chunks(pool, n, reorder_detail::CHUNK, [&](std::size_t v, std::size_t) {
+        const auto u = old_id[v];
+        const auto row = graph.neighbors(u);
+        const auto row_weights = graph.neighbor_weights(u);
+        std::vector<std::pair<std::uint32_t, W>> entries(row.size());
+        for (std::size_t i = 0; i < row.size(); ++i) {
+            entries[i] = {new_id[row[i]], row_weights[i]};
+        }
+        std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            targets[offsets[v] + i] = entries[i].first;
+            weights[offsets[v] + i] = entries[i].second;
+        }
+    });
+
+    return CsrGraph<V, W>(std::move(labels), std::move(offsets), std::move(targets), std::move(weights));
+}
+
+template <Vertex V, Weight W>
+CsrGraph<V, W> reorder(const CsrGraph<V, W>& graph, ReorderStrategy strategy, ThreadPool* pool = nullptr) {
+    return permute(graph, vertex_order(graph, strategy), pool);
+}
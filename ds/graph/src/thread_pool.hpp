@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// work stealing pool: every worker owns a deque, tasks submitted from a worker go to its own deque
+// and run lifo, tasks from outside are spread round robin, and an idle worker steals the oldest
+// task of the others. a worker waiting in parallel_for keeps running tasks instead of blocking
+class ThreadPool {
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queued{0};
+    std::atomic<std::size_t> next_queue{0};
+    std::mutex sleep_mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+
+    static inline thread_local const ThreadPool* current_pool = nullptr;
+    static inline thread_local std::size_t current_index = 0;
+
+public:
+    static constexpr std::size_t NOT_A_WORKER = std::numeric_limits<std::size_t>::max();
+
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency()) {
+        threads = std::max<std::size_t>(threads, 1);
+        queues.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this, i] {
+                worker_loop(i);
+            });
+        }
+    }
+
+    // queued tasks are still run before the workers exit
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(sleep_mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const {
+        return workers.size();
+    }
+
+    // index of the calling worker in [0, size()), NOT_A_WORKER for threads outside this pool. a
+    // worker only interleaves tasks while one of them waits on the pool, so tasks that never wait
+    // can use the index to select per-worker scratch space
+    std::size_t current_worker() const {
+        return current_pool == this ? current_index : NOT_A_WORKER;
+    }
+
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& fn) {
+        using R = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        auto future = task->get_future();
+
+        const auto worker = current_worker();
+        const auto target = worker != NOT_A_WORKER ? worker : next_queue.fetch_add(1, std::memory_order_relaxed) % size();
+        {
+            std::lock_guard lock(queues[target]->mutex);
+            queues[target]->tasks.emplace_back([task] {
+                (*task)();
+            });
+        }
+        queued.fetch_add(1);
+        {
+            // pairs with the predicate check of a worker going to sleep
+            std::lock_guard lock(sleep_mutex);
+        }
+        cv.notify_one();
+        return future;
+    }
+
+    // calls fn(i, slot) for every i in [0, n) and blocks until all are done, `slot` is in [0, size())
+    // and is never shared by two concurrent calls, so it can index per-worker scratch space
+    template <typename F>
+    void parallel_for(std::size_t n, F&& fn) {
+        std::atomic<std::size_t> next{0};
+        std::vector<std::future<void>> pending;
+        const auto slots = std::min(size(), n);
+        pending.reserve(slots);
+        for (std::size_t slot = 0; slot < slots; ++slot) {
+            pending.push_back(submit([&next, &fn, n, slot] {
+                for (auto i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+                    fn(i, slot);
+                }
+            }));
+        }
+        // wait for every slot before rethrowing, the tasks still reference `next` and `fn`
+        for (auto& future : pending) {
+            wait(future);
+        }
+        for (auto& future : pending) {
+            future.get();
+        }
+    }
+
+    // blocks until `future` is ready, a worker of this pool runs other tasks meanwhile so nested
+    // waits cannot starve the pool
+    template <typename T>
+    void wait(std::future<T>& future) {
+        const auto worker = current_worker();
+        if (worker == NOT_A_WORKER) {
+            future.wait();
+            return;
+        }
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (auto task = take(worker)) {
+                task();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    // own deque from the back, then the front of every other deque
+    std::function<void()> take(std::size_t index) {
+        for (std::size_t k = 0; k < queues.size(); ++k) {
+            auto& queue = *queues[(index + k) % queues.size()];
+            std::lock_guard lock(queue.mutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            std::function<void()> task;
+            if (k == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            queued.fetch_sub(1);
+            return task;
+        }
+        return {};
+    }
+
+    void worker_loop(std::size_t index) {
+        current_pool = this;
+        current_index = index;
+        while (true) {
+            if (auto task = take(index)) {
+                task();
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex);
+            cv.wait(lock, [this] {
+                return stopping || queued.load() > 0;
+            });
+            if (stopping && queued.load() == 0) {
+                return;
+            }
+        }
+    }
+};
+
+// fn(i, slot) for every i in [0, n), `chunk` consecutive indices per pool task so cheap bodies
+// amortize the scheduling. runs inline on slot 0 without a pool
+template <typename F>
+void parallel_chunks(ThreadPool* pool, std::size_t n, std::size_t chunk, F&& fn) {
+    const auto chunks = (n + chunk - 1) / chunk;
+    auto run = [&](std::size_t c, std::size_t slot) {
+        const auto end = std::min(n, (c + 1) * chunk);
+        for (auto i = c * chunk; i < end; ++i) {
+            fn(i, slot);
+        }
+    };
+    if (pool) {
+        pool->parallel_for(chunks, run);
+        return;
+    }
+    for (std::size_t c = 0; c < chunks; ++c) {
+        run(c, 0);
+    }
+}
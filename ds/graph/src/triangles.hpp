@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "csr.hpp"
+#include "thread_pool.hpp"
+
+// triangles and clustering of the undirected simple view: edge direction, parallel edges and
+// self-loops are ignored
+struct ClusteringResult {
+    std::vector<std::uint64_t> triangles;  // per dense id, triangles through the vertex
+    std::vector<double> coefficients;      // local clustering coefficient per dense id
+    std::uint64_t total = 0;               // triangles in the graph
+    double average = 0.0;                  // mean local coefficient over all vertices
+    double transitivity = 0.0;             // 3 * triangles / connected triples
+};
+
+namespace triangles_detail {
+    constexpr std::size_t CHUNK = 256;
+    // rows at least this long are marked in a bitmap once instead of being merged with every neighbor
+    constexpr std::size_t HUB_DEGREE = 2048;
+    // a merge is replaced by binary searches when one list is this many times longer
+    constexpr std::size_t GALLOP_RATIO = 32;
+
+    // |a ∩ b| of two strictly increasing lists, with Visit fn(x) is called for every common x.
+    // blocks of a are compared against every rotation of a block of b and the block with the
+    // smaller maximum moves on (all-pairs block merge, 8 lanes with avx2 and 4 with sse2)
+    template <bool Visit, typename F>
+    std::size_t intersect(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b, F&& fn) {
+        if (a.size() > b.size()) {
+            std::swap(a, b);
+        }
+        std::size_t count = 0;
+        auto report = [&](unsigned mask, std::size_t base) {
+            count += std::popcount(mask);
+            if constexpr (Visit) {
+                for (; mask != 0; mask &= mask - 1) {
+                    fn(a[base + std::countr_zero(mask)]);
+                }
+            }
+        };
+
+        if (a.size() * GALLOP_RATIO < b.size()) {
+            auto it = b.begin();
+            for (std::size_t k = 0; k < a.size(); ++k) {
+                it = std::lower_bound(it, b.end(), a[k]);
+                if (it == b.end()) {
+                    break;
+                }
+                if (*it == a[k]) {
+                    report(1, k);
+                }
+            }
+            return count;
+        }
+
+        std::size_t i = 0, j = 0;
+#if defined(__AVX2__)
+        const auto rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+        while (i + 8 <= a.size() && j + 8 <= b.size()) {
+            const auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.data() + i));
+            auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.data() + j));
+            auto equal = _mm256_cmpeq_epi32(va, vb);
+            for (int r = 1; r < 8; ++r) {
+                vb = _mm256_permutevar8x32_epi32(vb, rotate);
+                equal = _mm256_or_si256(equal, _mm256_cmpeq_epi32(va, vb));
+            }
+            report(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(equal))), i);
+            const auto a_max = a[i + 7];
+            const auto b_max = b[j + 7];
+            i += a_max <= b_max ? 8 : 0;
+            j += b_max <= a_max ? 8 : 0;
+        }
+#endif
+#if defined(__SSE2__)
+        while (i + 4 <= a.size() && j + 4 <= b.size()) {
+            const auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + i));
+            const auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + j));
+            auto equal = _mm_cmpeq_epi32(va, vb);
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+            report(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(equal))), i);
+            const auto a_max = a[i + 3];
+            const auto b_max = b[j + 3];
+            i += a_max <= b_max ? 4 : 0;
+            j += b_max <= a_max ? 4 : 0;
+        }
+#endif
+        while (i < a.size() && j < b.size()) {
+            if (a[i] < b[j]) {
+                ++i;
+            } else if (b[j] < a[i]) {
+                ++j;
+            } else {
+                report(1, i);
+                ++i;
+                ++j;
+            }
+        }
+        return count;
+    }
+
+    // undirected simple view oriented from lower to higher (degree, id) rank, vertices are
+    // renumbered by rank so every row is a sorted list of higher ranks. the out-degree of every
+    // vertex is then bounded by sqrt(2m), which keeps hub rows short
+    struct DegreeOrdered {
+        std::vector<std::uint32_t> order;      // dense id of every rank
+        std::vector<std::uint32_t> degree;     // undirected degree per dense id
+        std::vector<std::size_t> offsets;
+        std::vector<std::uint32_t> targets;
+
+        std::size_t size() const {
+            return order.size();
+        }
+
+        std::span<const std::uint32_t> row(std::size_t rank) const {
+            return {targets.data() + offsets[rank], offsets[rank + 1] - offsets[rank]};
+        }
+    };
+
+    // merges the sorted out- and in-rows of u, skipping duplicates and u itself
+    template <Vertex V, Weight W, typename F>
+    void for_each_neighbor(const CsrGraph<V, W>& graph, const CsrGraph<V, W>& in_edges, std::uint32_t u, F&& fn) {
+        const auto out = graph.neighbors(u);
+        const auto in = in_edges.neighbors(u);
+        std::size_t i = 0, j = 0;
+        std::uint32_t last = u;
+        while (i < out.size() || j < in.size()) {
+            std::uint32_t v;
+            if (j == in.size() || (i < out.size() && out[i] <= in[j])) {
+                v = out[i++];
+            } else {
+                v = in[j++];
+            }
+            if (v != u && v != last) {
+                fn(v);
+            }
+            last = v;
+        }
+    }
+
+    template <Vertex V, Weight W>
+    DegreeOrdered degree_ordered(const CsrGraph<V, W>& graph, ThreadPool* pool) {
+        const auto n = graph.size();
+        const auto in_edges = graph.transpose();
+        DegreeOrdered result;
+
+        result.degree.assign(n, 0);
+        parallel_chunks(pool, n, CHUNK, [&](std::size_t u, std::size_t) {
+            for_each_neighbor(graph, in_edges, static_cast<std::uint32_t>(u), [&](std::uint32_t) {
+                ++result.degree[u];
+            });
+        });
+
+        // counting sort by degree keeps ids increasing inside a degree
+        const auto max_degree = n == 0 ? 0 : *std::max_element(result.degree.begin(), result.degree.end());
+        std::vector<std::size_t> start(max_degree + 2, 0);
+        for (const auto d : result.degree) {
+            start[d + 1]++;
+        }
+        for (std::size_t d = 1; d < start.size(); ++d) {
+            start[d] += start[d - 1];
+        }
+        result.order.resize(n);
+        std::vector<std::uint32_t> rank(n);
+        for (std::uint32_t u = 0; u < n; ++u) {
+            rank[u] = static_cast<std::uint32_t>(start[result.degree[u]]++);
+            result.order[rank[u]] = u;
+        }
+
+        result.offsets.assign(n + 1, 0);
+        parallel_chunks(pool, n, CHUNK, [&](std::size_t r, std::size_t) {
+            std::size_t count = 0;
+            for_each_neighbor(graph, in_edges, result.order[r], [&](std::uint32_t v) {
+                count += rank[v] > r;
+            });
+            result.offsets[r + 1] = count;
+        });
+        for (std::size_t r = 0; r < n; ++r) {
+            result.offsets[r + 1] += result.offsets[r];
+        }
+
+        result.targets.resize(result.offsets.back());
+        parallel_chunks(pool, n, CHUNK, [&](std::size_t r, std::size_t) {
+            auto* out = result.targets.data() + result.offsets[r];
+            auto* end = out;
+            for_each_neighbor(graph, in_edges, result.order[r], [&](std::uint32_t v) {
+                if (rank[v] > r) {
+                    *end++ = rank[v];
+                }
+            });
+            std::sort(out, end);
+        });
+        return result;
+    }
+
+    // counts the triangles whose lowest rank is u, with Visit on_triangle(u, v, w) is also called for
+    // each of them in rank space. `marks` is the caller's bitmap over ranks, only touched for hub
+    // rows and left cleared
+    template <bool Visit, typename F>
+    std::uint64_t triangles_from(const DegreeOrdered& graph, std::size_t u, std::vector<std::uint64_t>& marks, F&& on_triangle) {
+        const auto row = graph.row(u);
+        std::uint64_t count = 0;
+        if (row.size() >= HUB_DEGREE) {
+            if (marks.empty()) {
+                marks.assign((graph.size() + 63) / 64, 0);
+            }
+            for (const auto v : row) {
+                marks[v / 64] |= std::uint64_t{1} << (v % 64);
+            }
+            for (const auto v : row) {
+                for (const auto w : graph.row(v)) {
+                    if ((marks[w / 64] >> (w % 64)) & 1) {
+                        ++count;
+                        if constexpr (Visit) {
+                            on_triangle(u, v, w);
+                        }
+                    }
+                }
+            }
+            for (const auto v : row) {
+                marks[v / 64] = 0;
+            }
+            return count;
+        }
+        for (std::size_t k = 0; k < row.size(); ++k) {
+            const auto v = row[k];
+            // every common neighbor outranks v, so only the rest of u's row can match
+            count += intersect<Visit>(row.subspan(k + 1), graph.row(v), [&](std::uint32_t w) {
+                on_triangle(u, v, w);
+            });
+        }
+        return count;
+    }
+}
+
+// every triangle is counted once from its lowest ranked vertex on the degree ordered orientation
+template <Vertex V, Weight W>
+std::uint64_t count_triangles(const CsrGraph<V, W>& graph, ThreadPool* pool = nullptr) {
+    using namespace triangles_detail;
+    const auto ordered = degree_ordered(graph, pool);
+    const auto slots = pool ? pool->size() : 1;
+    std::vector<std::uint64_t> counts(slots, 0);
+    std::vector<std::vector<std::uint64_t>> marks(slots);
+    parallel_chunks(pool, ordered.size(), CHUNK, [&](std::size_t u, std::size_t slot) {
+        counts[slot] += triangles_from<false>(ordered, u, marks[slot], [](auto, auto, auto) {});
+    });
+    std::uint64_t total = 0;
+    for (const auto count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+// triangles through every vertex and the local clustering coefficient 2 t(v) / (d(v) (d(v) - 1)),
+// zero for vertices with fewer than two neighbors
+template <Vertex V, Weight W>
+ClusteringResult clustering_coefficients(const CsrGraph<V, W>& graph, ThreadPool* pool = nullptr) {
+    using namespace triangles_detail;
+    const auto ordered = degree_ordered(graph, pool);
+    const auto n = ordered.size();
+    const auto slots = pool ? pool->size() : 1;
+
+    std::vector<std::uint64_t> per_rank(n, 0);
+    std::vector<std::uint64_t> counts(slots, 0);
+    std::vector<std::vector<std::uint64_t>> marks(slots);
+    auto add = [&](std::uint32_t rank) {
+        std::atomic_ref<std::uint64_t>(per_rank[rank]).fetch_add(1, std::memory_order_relaxed);
+    };
+    parallel_chunks(pool, n, CHUNK, [&](std::size_t u, std::size_t slot) {
+        counts[slot] += triangles_from<true>(ordered, u, marks[slot], [&](std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+            add(a);
+            add(b);
+            add(c);
+        });
+    });
+
+    ClusteringResult result;
+    result.triangles.resize(n);
+    result.coefficients.resize(n);
+    double wedges = 0.0;
+    double sum = 0.0;
+    for (std::size_t r = 0; r < n; ++r) {
+        const auto u = ordered.order[r];
+        const double d = ordered.degree[u];
+        result.triangles[u] = per_rank[r];
+        result.coefficients[u] = d < 2 ? 0.0 : 2.0 * per_rank[r] / (d * (d - 1));
+        wedges += d * (d - 1) / 2;
+        sum += result.coefficients[u];
+    }
+    for (const auto count : counts) {
+        result.total += count;
+    }
+    result.average = n == 0 ? 0.0 : sum / n;
+    result.transitivity = wedges == 0 ? 0.0 : 3.0 * result.total / wedges;
+    return result;
+}